@@ -1,6 +1,63 @@
 #include "File.hpp"
 
+#include <algorithm>
 #include <iostream>
+#include <stdexcept>
+
+#if defined(__linux__) || defined(__APPLE__)
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#elif defined(_WIN32)
+#    define NOMINMAX
+#    define WIN32_LEAN_AND_MEAN
+#    include <windows.h>
+#endif
+
+struct IE::Core::FileMapping::Region {
+    const std::byte       *data{};
+    std::size_t            size{};
+    // False if the contents were read into the fallback buffer rather than mapped.
+    bool                   mapped{false};
+    std::vector<std::byte> fallback;
+
+    Region() = default;
+
+    Region(const Region &) = delete;
+
+    Region &operator=(const Region &) = delete;
+
+    ~Region() {
+        if (!mapped) return;
+#if defined(__linux__) || defined(__APPLE__)
+        munmap(const_cast<std::byte *>(data), size);
+#elif defined(_WIN32)
+        UnmapViewOfFile(data);
+#endif
+    }
+};
+
+IE::Core::FileMapping::FileMapping(std::shared_ptr<const Region> t_region) :
+        m_region(std::move(t_region)),
+        m_bytes(m_region->data, m_region->size) {
+}
+
+std::span<const std::byte> IE::Core::FileMapping::bytes() const {
+    return m_bytes;
+}
+
+bool IE::Core::FileMapping::valid() const {
+    return m_region != nullptr;
+}
+
+IE::Core::FileMapping IE::Core::FileMapping::slice(std::size_t t_offset, std::size_t t_size) const {
+    if (t_offset > m_bytes.size() || t_size > m_bytes.size() - t_offset)
+        throw std::runtime_error("slice lies outside of the mapping!");
+    FileMapping slice{*this};
+    slice.m_bytes = m_bytes.subspan(t_offset, t_size);
+    return slice;
+}
 
 IE::Core::File::File(const std::filesystem::path &filePath) {
     path = filePath;
@@ -12,23 +69,48 @@ IE::Core::File::File(const std::filesystem::path &filePath) {
     close();
 }
 
+IE::Core::File::File(const std::filesystem::path &filePath, std::streamsize t_size) :
+        name(filePath.filename().string()),
+        path(filePath),
+        size(t_size),
+        extension(filePath.extension().string()) {
+}
+
+IE::Core::File::File(const std::filesystem::path &filePath, IE::Core::FileMapping t_contents) :
+        name(filePath.filename().string()),
+        path(filePath),
+        size(static_cast<std::streamsize>(t_contents.bytes().size())),
+        extension(filePath.extension().string()),
+        m_contents(std::move(t_contents)) {
+}
+
 IE::Core::File::File(const IE::Core::File &file) {
-    name      = file.name;
-    path      = file.path;
-    size      = file.size;
-    extension = file.extension;
+    name       = file.name;
+    path       = file.path;
+    size       = file.size;
+    extension  = file.extension;
+    m_contents = file.m_contents;
 }
 
 IE::Core::File &IE::Core::File::operator=(const IE::Core::File &file) {
     if (this == &file) return *this;
-    name      = file.name;
-    path      = file.path;
-    size      = file.size;
-    extension = file.extension;
+    name       = file.name;
+    path       = file.path;
+    size       = file.size;
+    extension  = file.extension;
+    m_contents = file.m_contents;
+    // The descriptor and mapping belong to the old path, so they must not be used for the new one.
+    {
+        std::lock_guard<std::mutex> lock(m_mappingMutex);
+        m_mapping.reset();
+    }
+    std::lock_guard<std::mutex> lock(m_descriptorMutex);
+    m_descriptor.reset();
     return *this;
 }
 
 std::vector<char> IE::Core::File::read() {
+    if (m_contents.valid()) return read(static_cast<std::streamsize>(m_contents.bytes().size()), 0);
     std::vector<char> data(size);
     open(std::fstream::in | std::fstream::binary);
     getSize();
@@ -39,10 +121,21 @@ std::vector<char> IE::Core::File::read() {
 }
 
 std::vector<char> IE::Core::File::read(std::streamsize numBytes, std::streamsize startPosition) {
-    std::vector<char> data(size);
-    open();
+    if (m_contents.valid()) {
+        std::span<const std::byte> bytes = m_contents.bytes();
+        auto                       total = static_cast<std::streamsize>(bytes.size());
+        std::streamsize            start = std::clamp<std::streamsize>(startPosition, 0, total);
+        std::streamsize            count = std::clamp<std::streamsize>(numBytes, 0, total - start);
+        const auto                *first = reinterpret_cast<const char *>(bytes.data()) + start;
+        return {first, first + count};
+    }
+    open(std::fstream::in | std::fstream::binary);
+    // Only allocate what was asked for, and no more than the file holds past the start position.
+    std::streamsize   available = std::max<std::streamsize>(getSize() - startPosition, 0);
+    std::vector<char> data(std::clamp<std::streamsize>(numBytes, 0, available));
     fileIO.seekg(startPosition);
-    fileIO.read(data.data(), numBytes);
+    fileIO.read(data.data(), static_cast<std::streamsize>(data.size()));
+    data.resize(fileIO.gcount());
     close();
     return data;
 }
@@ -92,4 +185,105 @@ void IE::Core::File::open(std::ios::openmode mode) {
 
 void IE::Core::File::close() {
     if (fileIO.is_open()) fileIO.close();
-}
\ No newline at end of file
+}
+
+IE::Core::FileMapping IE::Core::File::map(IE::Core::AccessPattern t_accessPattern) {
+    if (m_contents.valid()) return m_contents;
+    std::lock_guard<std::mutex>                lock(m_mappingMutex);
+    std::shared_ptr<const FileMapping::Region> region = m_mapping.lock();
+    if (region == nullptr) {
+        auto newRegion = std::make_shared<FileMapping::Region>();
+#if defined(__linux__) || defined(__APPLE__)
+        int descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (descriptor < 0) return {};
+        struct stat status {};
+        if (fstat(descriptor, &status) != 0) {
+            ::close(descriptor);
+            return {};
+        }
+        newRegion->size = static_cast<std::size_t>(status.st_size);
+        // Empty files can not be mapped, but there is nothing to map anyway.
+        if (newRegion->size > 0) {
+            void *address = mmap(nullptr, newRegion->size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+            if (address == MAP_FAILED) {
+                ::close(descriptor);
+                return {};
+            }
+            newRegion->data   = static_cast<const std::byte *>(address);
+            newRegion->mapped = true;
+        }
+        // The mapping keeps its own reference to the file.
+        ::close(descriptor);
+#elif defined(_WIN32)
+        DWORD flags = t_accessPattern == IE_ACCESS_PATTERN_SEQUENTIAL ? FILE_FLAG_SEQUENTIAL_SCAN :
+                      t_accessPattern == IE_ACCESS_PATTERN_RANDOM     ? FILE_FLAG_RANDOM_ACCESS :
+                                                                        FILE_ATTRIBUTE_NORMAL;
+        HANDLE file =
+          CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, flags, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return {};
+        LARGE_INTEGER fileSize{};
+        GetFileSizeEx(file, &fileSize);
+        newRegion->size = static_cast<std::size_t>(fileSize.QuadPart);
+        if (newRegion->size > 0) {
+            HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            // The view keeps its own references to the mapping and the file.
+            void  *view    = mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+            if (mapping != nullptr) CloseHandle(mapping);
+            if (view == nullptr) {
+                CloseHandle(file);
+                return {};
+            }
+            newRegion->data   = static_cast<const std::byte *>(view);
+            newRegion->mapped = true;
+        }
+        CloseHandle(file);
+#else
+        std::ifstream file{path, std::ios::in | std::ios::binary | std::ios::ate};
+        if (!file.is_open()) return {};
+        newRegion->fallback.resize(static_cast<std::size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char *>(newRegion->fallback.data()), newRegion->fallback.size());
+        newRegion->data = newRegion->fallback.data();
+        newRegion->size = newRegion->fallback.size();
+#endif
+        region    = newRegion;
+        m_mapping = region;
+    }
+#if defined(__linux__) || defined(__APPLE__)
+    // Every reader may have its own idea of how it is going to read, so the hint is given every time.
+    if (region->mapped) {
+        void *address = const_cast<std::byte *>(region->data);
+        if (t_accessPattern == IE_ACCESS_PATTERN_SEQUENTIAL) {
+            posix_madvise(address, region->size, POSIX_MADV_SEQUENTIAL);
+            posix_madvise(address, region->size, POSIX_MADV_WILLNEED);
+        } else if (t_accessPattern == IE_ACCESS_PATTERN_RANDOM) {
+            posix_madvise(address, region->size, POSIX_MADV_RANDOM);
+        } else posix_madvise(address, region->size, POSIX_MADV_NORMAL);
+    }
+#endif
+    return FileMapping{region};
+}
+
+IE::Core::AsyncRead IE::Core::File::readAsync(
+  IE::Core::Threading::ThreadPool *t_threadPool,
+  std::streamsize                  t_offset,
+  std::streamsize                  t_length,
+  char                            *t_buffer
+) {
+    if (m_contents.valid()) {
+        // The contents are already in memory, so there is nothing to wait for.
+        std::vector<char> data = read(t_length, t_offset);
+        std::copy(data.begin(), data.end(), t_buffer);
+        return AsyncRead{static_cast<std::streamsize>(data.size())};
+    }
+    std::shared_ptr<const FileDescriptor> descriptor;
+    {
+        std::lock_guard<std::mutex> lock(m_descriptorMutex);
+        descriptor = m_descriptor.lock();
+        if (descriptor == nullptr) {
+            descriptor   = std::make_shared<const FileDescriptor>(path);
+            m_descriptor = descriptor;
+        }
+    }
+    return {t_threadPool, std::move(descriptor), &path, t_offset, t_length, t_buffer};
+}
@@ -1,11 +1,53 @@
 #pragma once
 
+#include "IOService.hpp"
+
+#include <cstddef>
 #include <filesystem>
 #include <fstream>
+#include <memory>
+#include <mutex>
+#include <span>
 #include <string>
 #include <vector>
 
 namespace IE::Core {
+enum AccessPattern {
+    IE_ACCESS_PATTERN_NORMAL,      // No hint.
+    IE_ACCESS_PATTERN_SEQUENTIAL,  // Read from front to back. The file is read ahead as soon as it is mapped.
+    IE_ACCESS_PATTERN_RANDOM,      // Read in no particular order, so nothing is read ahead.
+};
+
+/**
+ * @brief A read-only view of the contents of a file, mapped into memory.
+ * @details Pages are only read from disk once they are touched, and never copied, so mapping even a very large
+ * file costs no more memory than the pages that are actually used. Copies share one mapping, which is unmapped
+ * once the last of them is destroyed, even if that outlives the File that it came from. On platforms that can
+ * not map files, the contents are read into memory instead.
+ */
+class FileMapping {
+public:
+    FileMapping() = default;
+
+    [[nodiscard]] std::span<const std::byte> bytes() const;
+
+    /** @return False if the file could not be mapped. */
+    [[nodiscard]] bool valid() const;
+
+    /** @return A view of t_size bytes of this one starting at t_offset, which keeps the whole mapping alive. */
+    [[nodiscard]] FileMapping slice(std::size_t t_offset, std::size_t t_size) const;
+
+private:
+    struct Region;
+
+    std::shared_ptr<const Region> m_region;
+    std::span<const std::byte>    m_bytes;
+
+    explicit FileMapping(std::shared_ptr<const Region> t_region);
+
+    friend class File;
+};
+
 class File {
 public:
     std::string           name;
@@ -17,9 +59,16 @@ public:
     // Constructor
     explicit File(const std::filesystem::path &filePath);
 
+    // Constructor for a file whose size is already known, which does not need to open it
+    File(const std::filesystem::path &filePath, std::streamsize t_size);
+
+    // Constructor for a file that is served from memory, such as from a pack, rather than read from disk
+    File(const std::filesystem::path &filePath, FileMapping t_contents);
+
     // Copy constructor and = overload must be defined explicitly because fstream has no defaults for them
     File(const File &file);
 
+    /** Any asynchronous reads of this file must have finished, as they refer to its path. */
     File &operator=(const File &file);
 
     // Read the entire file
@@ -34,7 +83,38 @@ public:
     // Overwrite a section of the file
     void overwrite(const std::vector<char> &data, std::streamsize startPosition = -1);
 
+    /**
+     * @brief Map the whole file into memory for reading, without copying it.
+     * @details Readers that map the file while an earlier mapping of it is still alive share that mapping.
+     * t_accessPattern is passed on to the operating system as a hint for how to read ahead.
+     * @return An invalid mapping if the file could not be opened.
+     */
+    FileMapping map(AccessPattern t_accessPattern = IE_ACCESS_PATTERN_SEQUENTIAL);
+
+    /**
+     * @brief Read t_length bytes starting at t_offset into t_buffer, with co_await.
+     * @details The read is made by the IOService, and the awaiting coroutine is resumed on t_threadPool once it
+     * has finished, so no worker is held while the disk is busy. Reads that are in progress at the same time
+     * share one descriptor, which is closed once the last of them has finished, so a File only holds a descriptor
+     * while it is being read. Both this file and t_buffer must outlive the read. The co_await throws
+     * std::runtime_error if the file can not be read.
+     * @return An awaitable that evaluates to the number of bytes read.
+     */
+    AsyncRead readAsync(
+      Threading::ThreadPool *t_threadPool,
+      std::streamsize        t_offset,
+      std::streamsize        t_length,
+      char                  *t_buffer
+    );
+
 private:
+    // Only valid for files served from memory, which every read is then made from.
+    FileMapping                              m_contents;
+    std::mutex                               m_mappingMutex;
+    std::weak_ptr<const FileMapping::Region> m_mapping;
+    std::mutex                               m_descriptorMutex;
+    std::weak_ptr<const FileDescriptor>      m_descriptor;
+
     std::streamsize getSize();
 
     // Open a file for reading and writing
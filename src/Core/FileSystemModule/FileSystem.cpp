@@ -2,14 +2,27 @@
 
 #include "File.hpp"
 
+#include <algorithm>
+#include <cstdio>
 #include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace {
+/// The first line of an index cache. Caches that start with anything else are ignored.
+constexpr const char *INDEX_CACHE_HEADER{"IEFileIndex 1"};
+}  // namespace
 
 IE::Core::File *IE::Core::FileSystem::addFile(const std::filesystem::path &filePath) {
     std::filesystem::path newPath(filePath);
     makePathAbsolute(newPath);
     createFolder(newPath.parent_path().string());
-    auto file = getFile(newPath);
-    if (file == nullptr) return &(*m_files.insert(std::make_pair(filePath.string(), File(newPath))).first).second;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto                        file = findFile(newPath);
+    // The file does not exist yet, so there is nothing to index until it is written.
+    if (file == nullptr) file = &m_files.try_emplace(newPath.string(), newPath).first->second;
+    // The caller is about to write the file.
+    else revalidate(newPath);
     return file;
 }
 
@@ -23,12 +36,20 @@ void IE::Core::FileSystem::createFolder(const std::filesystem::path &folderPath)
 }
 
 void IE::Core::FileSystem::exportData(const std::filesystem::path &filePath, const std::vector<char> &data) {
-    m_files.find(filePath.string())->second.write(data);
+    getFile(filePath)->write(data);
+    std::filesystem::path newPath(filePath);
+    makePathAbsolute(newPath);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    revalidate(newPath);
 }
 
 void IE::Core::FileSystem::deleteFile(const std::filesystem::path &filePath) {
-    m_files.erase(m_files.find(filePath.string()));
-    std::filesystem::remove(m_path / filePath);
+    std::filesystem::path newPath(filePath);
+    makePathAbsolute(newPath);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_files.erase(newPath.string());
+    if (m_index.erase(indexKey(newPath)) > 0) m_indexChanged = true;
+    std::filesystem::remove(newPath);
 }
 
 void IE::Core::FileSystem::deleteDirectory(const std::filesystem::path &filePath) const {
@@ -37,20 +58,23 @@ void IE::Core::FileSystem::deleteDirectory(const std::filesystem::path &filePath
 }
 
 void IE::Core::FileSystem::deleteUsedDirectory(const std::filesystem::path &filePath) {
-    std::string testPath;
-    for (const auto &x : m_files) {
-        testPath = x.second.path.string().substr(0, filePath.string().size());
-        if (testPath == filePath) m_files.erase(x.first);
-    }
-    std::filesystem::remove_all(m_path / filePath);
+    std::filesystem::path newPath(filePath);
+    makePathAbsolute(newPath);
+    // Compare against the path with a trailing separator, so that directories that share a prefix are kept.
+    std::string                 directory = (newPath / "").string();
+    std::string                 key       = indexKey(newPath) + "/";
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::erase_if(m_files, [&](const auto &t_file) { return t_file.first.starts_with(directory); });
+    if (std::erase_if(m_index, [&](const auto &t_entry) { return t_entry.first.starts_with(key); }) > 0)
+        m_indexChanged = true;
+    std::filesystem::remove_all(newPath);
 }
 
 IE::Core::File *IE::Core::FileSystem::getFile(const std::filesystem::path &filePath) {
     std::filesystem::path newPath(filePath);
     makePathAbsolute(newPath);
-    auto iterator = m_files.find(newPath.string());
-    if (iterator == m_files.end()) return nullptr;
-    return &iterator->second;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return findFile(newPath);
 }
 
 std::filesystem::path IE::Core::FileSystem::getBaseDirectory(const std::filesystem::path &t_path) {
@@ -58,11 +82,203 @@ std::filesystem::path IE::Core::FileSystem::getBaseDirectory(const std::filesyst
 }
 
 void IE::Core::FileSystem::setBaseDirectory(const std::filesystem::path &t_path) {
+    std::lock_guard<std::mutex> lock(m_mutex);
     m_path = t_path;
     m_files.clear();
-    std::filesystem::recursive_directory_iterator directory{t_path};
-    for (auto entry : directory)
-        if (!entry.is_directory()) addFile(entry.path());
+    m_packedContentHashes.clear();
+    loadIndex();
+}
+
+void IE::Core::FileSystem::mount(const std::filesystem::path &t_packPath) {
+    std::filesystem::path path(t_packPath);
+    // Mapping and checking the pack touches the disk, so it is done before taking the lock.
+    Pack                        pack(makePathAbsolute(path));
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_packs.push_back(std::move(pack));
+    m_packedContentHashes.clear();
+}
+
+IE::Core::FileMapping IE::Core::FileSystem::mapFile(const std::filesystem::path &t_filePath) {
+    File *file = getFile(t_filePath);
+    return file != nullptr ? file->map() : FileMapping{};
+}
+
+uint64_t IE::Core::FileSystem::getContentHash(const std::filesystem::path &t_filePath) {
+    std::filesystem::path path(t_filePath);
+    makePathAbsolute(path);
+    std::string     key = indexKey(path);
+    FileMapping     packed;
+    std::streamsize size{};
+    int64_t         modificationTime{};
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        packed = findPacked(key);
+        if (packed.valid()) {
+            // Packs can not change while mounted, so their files are hashed once per run rather than indexed.
+            auto hash = m_packedContentHashes.find(key);
+            if (hash != m_packedContentHashes.end()) return hash->second;
+        } else {
+            IndexEntry *entry = updateIndex(path);
+            if (entry == nullptr) return 0;
+            if (entry->contentHash != 0) return entry->contentHash;
+            size             = entry->size;
+            modificationTime = entry->modificationTime;
+        }
+    }
+    // Hashing a large file takes a while, so other threads are left free to look files up in the meantime. The
+    // index already knows the size of a loose file, so only map() opens it.
+    FileMapping                 contents = packed.valid() ? packed : File{path, size}.map();
+    uint64_t                    hash     = hashContents(contents.bytes());
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (packed.valid()) {
+        m_packedContentHashes[key] = hash;
+        return hash;
+    }
+    // The entry may have been removed or replaced while the lock was not held.
+    auto entry = m_index.find(key);
+    if (entry != m_index.end() && entry->second.modificationTime == modificationTime) {
+        entry->second.contentHash = hash;
+        m_indexChanged            = true;
+    }
+    return hash;
+}
+
+uint64_t IE::Core::FileSystem::hashContents(std::span<const std::byte> t_bytes) {
+    uint64_t hash{14695981039346656037ULL};
+    for (std::byte byte : t_bytes) {
+        hash ^= static_cast<uint64_t>(byte);
+        hash *= 1099511628211ULL;
+    }
+    // 0 marks a file that has not been hashed.
+    return hash != 0 ? hash : 1;
+}
+
+void IE::Core::FileSystem::saveIndex() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_indexChanged) return;
+    std::filesystem::path path = m_path / INDEX_CACHE_PATH;
+    std::error_code       error;
+    std::filesystem::create_directories(path.parent_path(), error);
+    // Write to a temporary file first, so that a run that stops part way through can not leave a broken index.
+    std::filesystem::path temporaryPath = path.string() + ".tmp";
+    {
+        std::ofstream cache{temporaryPath, std::ios::out | std::ios::trunc};
+        if (!cache.is_open()) return;
+        cache << INDEX_CACHE_HEADER << '\n';
+        for (const auto &[key, entry] : m_index)
+            cache << entry.size << ' ' << entry.modificationTime << ' ' << entry.contentHash << ' ' << key << '\n';
+        if (!cache) return;
+    }
+    std::filesystem::rename(temporaryPath, path, error);
+    if (!error) m_indexChanged = false;
+}
+
+IE::Core::FileMapping IE::Core::FileSystem::loadDerivedData(const DerivedDataKey &t_key) {
+    // Derived data is never modified once stored, so it does not need to go through the index. The mapping sizes
+    // the file itself, so only map() opens it.
+    return File{derivedDataPath(t_key), 0}.map(IE_ACCESS_PATTERN_SEQUENTIAL);
+}
+
+void IE::Core::FileSystem::storeDerivedData(const DerivedDataKey &t_key, std::span<const std::byte> t_data) {
+    std::filesystem::path path = derivedDataPath(t_key);
+    std::error_code       error;
+    std::filesystem::create_directories(path.parent_path(), error);
+    // Several threads may derive the same data at once, so each writes to a temporary file of its own.
+    std::filesystem::path temporaryPath =
+      path.string() + "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+    {
+        std::ofstream output{temporaryPath, std::ios::out | std::ios::binary | std::ios::trunc};
+        output.write(reinterpret_cast<const char *>(t_data.data()), static_cast<std::streamsize>(t_data.size()));
+        if (!output) {
+            output.close();
+            std::filesystem::remove(temporaryPath, error);
+            return;
+        }
+    }
+    std::filesystem::rename(temporaryPath, path, error);
+    if (error) std::filesystem::remove(temporaryPath, error);
+}
+
+IE::Core::File *IE::Core::FileSystem::findFile(const std::filesystem::path &t_absolutePath) {
+    auto iterator = m_files.find(t_absolutePath.string());
+    if (iterator != m_files.end()) return &iterator->second;
+    FileMapping packed = findPacked(indexKey(t_absolutePath));
+    if (packed.valid())
+        return &m_files.try_emplace(t_absolutePath.string(), t_absolutePath, std::move(packed)).first->second;
+    // Look the file up on first use. Unmodified files already have their size in the index, so are not opened.
+    IndexEntry *entry = updateIndex(t_absolutePath);
+    if (entry == nullptr) return nullptr;
+    return &m_files.try_emplace(t_absolutePath.string(), t_absolutePath, entry->size).first->second;
+}
+
+IE::Core::FileMapping IE::Core::FileSystem::findPacked(const std::string &t_key) const {
+    for (auto pack = m_packs.rbegin(); pack != m_packs.rend(); ++pack)
+        if (std::optional<FileMapping> mapping = pack->find(t_key)) return *mapping;
+    return {};
+}
+
+IE::Core::FileSystem::IndexEntry *IE::Core::FileSystem::updateIndex(const std::filesystem::path &t_absolutePath) {
+    std::error_code error;
+    std::string     key   = indexKey(t_absolutePath);
+    auto            known = m_index.find(key);
+    // Every check costs a few system calls, so each file is only checked once per run.
+    if (known != m_index.end() && known->second.validated) return &known->second;
+    if (!std::filesystem::is_regular_file(t_absolutePath, error)) {
+        if (m_index.erase(key) > 0) m_indexChanged = true;
+        return nullptr;
+    }
+    int64_t modificationTime =
+      std::filesystem::last_write_time(t_absolutePath, error).time_since_epoch().count();
+    auto [iterator, inserted] = m_index.try_emplace(key);
+    IndexEntry &entry         = iterator->second;
+    if (inserted || entry.modificationTime != modificationTime) {
+        auto size      = std::filesystem::file_size(t_absolutePath, error);
+        entry          = {.size             = error ? 0 : static_cast<std::streamsize>(size),
+                          .modificationTime = modificationTime,
+                          .contentHash      = 0,
+                          .validated        = true};
+        m_indexChanged = true;
+    } else entry.validated = true;
+    return &entry;
+}
+
+void IE::Core::FileSystem::revalidate(const std::filesystem::path &t_absolutePath) {
+    auto entry = m_index.find(indexKey(t_absolutePath));
+    if (entry != m_index.end()) entry->second.validated = false;
+}
+
+std::string IE::Core::FileSystem::indexKey(const std::filesystem::path &t_absolutePath) const {
+    return t_absolutePath.lexically_relative(m_path).lexically_normal().generic_string();
 }
 
-IE::Core::FileSystem::FileSystem() = default;
\ No newline at end of file
+std::filesystem::path IE::Core::FileSystem::derivedDataPath(const DerivedDataKey &t_key) const {
+    char name[64];
+    std::snprintf(
+      name,
+      sizeof(name),
+      "%016llx-%016llx-%u",
+      static_cast<unsigned long long>(t_key.contentHash),
+      static_cast<unsigned long long>(t_key.parameters),
+      t_key.version
+    );
+    return m_path / DERIVED_DATA_PATH / name;
+}
+
+void IE::Core::FileSystem::loadIndex() {
+    m_index.clear();
+    m_indexChanged = false;
+    std::ifstream cache{m_path / INDEX_CACHE_PATH};
+    std::string   line;
+    if (!std::getline(cache, line) || line != INDEX_CACHE_HEADER) return;
+    IndexEntry entry{};
+    // Entries are only trusted once the file's modification time has been checked against them on first use.
+    while (cache >> entry.size >> entry.modificationTime >> entry.contentHash && cache.get() == ' ' &&
+           std::getline(cache, line))
+        m_index.emplace(line, entry);
+}
+
+IE::Core::FileSystem::FileSystem() = default;
+
+IE::Core::FileSystem::~FileSystem() {
+    saveIndex();
+}
\ No newline at end of file
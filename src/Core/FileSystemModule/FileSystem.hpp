@@ -2,7 +2,10 @@
 
 #include "File.hpp"
 #include "Importer.hpp"
+#include "Pack.hpp"
 
+#include <cstdint>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -10,11 +13,30 @@
 namespace IE::Core {
 class FileSystem {
 public:
+    /// Where the index of known files is kept between runs, relative to the base directory.
+    static constexpr const char *INDEX_CACHE_PATH{"cache/FileIndex"};
+    /// Where data derived from files is kept between runs, relative to the base directory.
+    static constexpr const char *DERIVED_DATA_PATH{"cache/derived"};
+
+    /** Identifies data derived from a file. Anything that changes the result must change the key. */
+    struct DerivedDataKey {
+        uint64_t contentHash;  // From getContentHash().
+        uint64_t parameters;   // Whatever settings the data was derived with.
+        uint32_t version;      // Changed whenever the format of the data changes.
+    };
+
     FileSystem();
 
+    // Save the index for the next run
+    ~FileSystem();
+
     // Create a new File with the given relative path
     File *addFile(const std::filesystem::path &filePath);
 
+    /**
+     * @return The file at filePath, served from the last mounted pack that holds it or otherwise from disk, or
+     * nullptr if there is no such file.
+     */
     File *getFile(const std::filesystem::path &filePath);
 
     void createFolder(const std::filesystem::path &folderPath) const;
@@ -31,12 +53,54 @@ public:
     // Delete a directory that has other files in it
     void deleteUsedDirectory(const std::filesystem::path &filePath);
 
+    /**
+     * @brief Set the directory that relative paths are resolved against, and load the index saved under it.
+     * @details Nothing below the directory is enumerated. Files are looked up when they are first asked for, and
+     * the index lets files that have not been modified since it was saved be used without opening them.
+     */
     void setBaseDirectory(const std::filesystem::path &t_path);
 
     std::filesystem::path getBaseDirectory(const std::filesystem::path &t_path);
 
     std::filesystem::path &makePathAbsolute(std::filesystem::path &filePath);
 
+    /**
+     * @brief Serve the files in the pack at t_packPath as if they were below the base directory.
+     * @details Packs mounted later take precedence over earlier ones, and all packs over loose files. Files that
+     * have already been asked for keep being served from where they were found, so packs should be mounted before
+     * anything is loaded. Throws std::runtime_error if the pack is not valid.
+     */
+    void mount(const std::filesystem::path &t_packPath);
+
+    /**
+     * @return The contents of the file at t_filePath, as found by getFile(). Invalid if there is no such file.
+     */
+    FileMapping mapFile(const std::filesystem::path &t_filePath);
+
+    /**
+     * @return A hash of the contents of the file at t_filePath, or 0 if there is no such file. The hash is kept in
+     * the index until the file is modified. Files are only checked for modifications the first time that they are
+     * used in a run, and again after they are written through addFile() or exportData().
+     */
+    uint64_t getContentHash(const std::filesystem::path &t_filePath);
+
+    /** @return The 64-bit FNV-1a hash of t_bytes, as getContentHash() hashes files. Never 0. */
+    static uint64_t hashContents(std::span<const std::byte> t_bytes);
+
+    /** Write the index to INDEX_CACHE_PATH if it has changed, so that the next run can reuse it. */
+    void saveIndex();
+
+    /** @return The data stored under t_key, mapped into memory, or an invalid mapping if there is none. */
+    FileMapping loadDerivedData(const DerivedDataKey &t_key);
+
+    /**
+     * @brief Store t_data under t_key in DERIVED_DATA_PATH, for this and later runs.
+     * @details The data is written to a temporary file and then moved into place, so that concurrent readers and
+     * runs that stop part way through never see half of it. Failures are ignored, as the data can be derived
+     * again.
+     */
+    void storeDerivedData(const DerivedDataKey &t_key, std::span<const std::byte> t_data);
+
     template<class T>
     void importFile(T *data, File &file, unsigned int flags = 0) {
         m_importer.import(data, file, flags);
@@ -48,8 +112,43 @@ public:
     };
 
 private:
-    std::filesystem::path                 m_path;
-    Importer                              m_importer{};
-    std::unordered_map<std::string, File> m_files;
+    /** What is known about a file. Trusted for as long as the file's modification time stays the same. */
+    struct IndexEntry {
+        std::streamsize size;
+        int64_t         modificationTime;
+        uint64_t        contentHash;  // 0 if not yet hashed.
+        bool            validated;    // Checked against the file in this run. Not saved.
+    };
+
+    std::filesystem::path                       m_path;
+    Importer                                    m_importer{};
+    std::mutex                                  m_mutex;
+    std::unordered_map<std::string, File>       m_files;
+    // Keyed by the path relative to the base directory, separated by '/'.
+    std::unordered_map<std::string, IndexEntry> m_index;
+    bool                                        m_indexChanged{false};
+    std::vector<Pack>                           m_packs;
+    // Keyed like m_index. Cleared whenever a pack is mounted, as that may change which file a path refers to.
+    std::unordered_map<std::string, uint64_t>   m_packedContentHashes;
+
+    File *findFile(const std::filesystem::path &t_absolutePath);
+
+    /** @return The contents of the file at t_key from the last mounted pack that holds it, or else invalid. */
+    FileMapping findPacked(const std::string &t_key) const;
+
+    /**
+     * @brief Bring the index entry of the file at t_absolutePath up to date with the file on disk.
+     * @return The entry, or nullptr if there is no such file.
+     */
+    IndexEntry *updateIndex(const std::filesystem::path &t_absolutePath);
+
+    /** Have the index entry of the file at t_absolutePath checked again on its next use. m_mutex must be held. */
+    void revalidate(const std::filesystem::path &t_absolutePath);
+
+    std::string indexKey(const std::filesystem::path &t_absolutePath) const;
+
+    std::filesystem::path derivedDataPath(const DerivedDataKey &t_key) const;
+
+    void loadIndex();
 };
 }  // namespace IE::Core
\ No newline at end of file
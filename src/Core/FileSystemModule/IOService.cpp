@@ -0,0 +1,435 @@
+#include "IOService.hpp"
+
+#include "Core/ThreadingModule/ThreadPool.hpp"
+#include "Core/ThreadingModule/Topology.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#if defined(__linux__) || defined(__APPLE__)
+#    include <fcntl.h>
+#    include <unistd.h>
+#endif
+#if defined(__linux__)
+#    include <linux/io_uring.h>
+#    include <sys/eventfd.h>
+#    include <sys/mman.h>
+#    include <sys/syscall.h>
+#endif
+
+#if defined(__linux__)
+/** The memory shared with the kernel for one io_uring. Only ever touched by the service thread. */
+struct IE::Core::IOService::Ring {
+    int            fileDescriptor{-1};
+    uint32_t       entryCount{};
+    // The submission queue.
+    void          *submissionMemory{MAP_FAILED};
+    std::size_t    submissionMemorySize{};
+    uint32_t      *submissionTail{};
+    uint32_t      *submissionMask{};
+    uint32_t      *submissionArray{};
+    io_uring_sqe  *entries{static_cast<io_uring_sqe *>(MAP_FAILED)};
+    // The completion queue. Shares the submission queue's memory on kernels that support it.
+    void          *completionMemory{MAP_FAILED};
+    std::size_t    completionMemorySize{};
+    uint32_t      *completionHead{};
+    uint32_t      *completionTail{};
+    uint32_t      *completionMask{};
+    io_uring_cqe  *completions{};
+    uint32_t       tail{};               // The submission queue's tail, including entries not yet published.
+    uint32_t       unsubmittedCount{0};  // Entries that the kernel has not taken yet.
+
+    Ring() = default;
+
+    Ring(const Ring &) = delete;
+
+    Ring &operator=(const Ring &) = delete;
+
+    ~Ring() {
+        if (entries != MAP_FAILED) munmap(entries, entryCount * sizeof(io_uring_sqe));
+        if (completionMemory != MAP_FAILED && completionMemory != submissionMemory)
+            munmap(completionMemory, completionMemorySize);
+        if (submissionMemory != MAP_FAILED) munmap(submissionMemory, submissionMemorySize);
+        if (fileDescriptor >= 0) ::close(fileDescriptor);
+    }
+
+    /** Fill in the next submission queue entry with a read. The ring must have room for it. */
+    void prepareRead(int t_fileDescriptor, void *t_buffer, uint32_t t_length, uint64_t t_offset, uint64_t t_data) {
+        uint32_t      index = tail++ & *submissionMask;
+        io_uring_sqe &entry = entries[index];
+        std::memset(&entry, 0, sizeof(entry));
+        entry.opcode           = IORING_OP_READ;
+        entry.fd               = t_fileDescriptor;
+        entry.addr             = reinterpret_cast<uint64_t>(t_buffer);
+        entry.len              = t_length;
+        entry.off              = t_offset;
+        entry.user_data        = t_data;
+        submissionArray[index] = index;
+        ++unsubmittedCount;
+    }
+
+    /** Hand the prepared entries to the kernel, then wait until at least one completion is available. */
+    void enter() {
+        // The kernel reads the entries once it sees the new tail.
+        __atomic_store_n(submissionTail, tail, __ATOMIC_RELEASE);
+        int result = static_cast<int>(
+          syscall(__NR_io_uring_enter, fileDescriptor, unsubmittedCount, 1, IORING_ENTER_GETEVENTS, nullptr, 0)
+        );
+        // Entries are only left over if the call was interrupted, in which case they go in with the next one.
+        if (result > 0) unsubmittedCount -= std::min<uint32_t>(result, unsubmittedCount);
+    }
+};
+#endif
+
+namespace {
+#if defined(__linux__)
+/// The user data of the read that waits on the wakeup eventfd. Requests are never at this address.
+constexpr uint64_t WAKEUP_DATA{0};
+/// Reads from the current position, as an eventfd has no offsets.
+constexpr uint64_t NO_OFFSET{~uint64_t{0}};
+#endif
+}  // namespace
+
+IE::Core::IOService &IE::Core::IOService::get() {
+    static IOService ioService;
+    return ioService;
+}
+
+IE::Core::IOService::~IOService() {
+    m_shutdown = true;
+#if defined(__linux__)
+    if (m_ring != nullptr) {
+        uint64_t value{1};
+        (void) write(m_wakeup, &value, sizeof(value));
+    }
+#endif
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_condition.notify_all();
+    }
+    for (std::thread &thread : m_threads)
+        if (thread.joinable()) thread.join();
+    // Nothing reads the requests that are left any more, so resume their coroutines rather than leak them.
+    std::deque<Request *> pending;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        pending.swap(m_pending);
+    }
+    for (Request *request : pending) cancel(request);
+#if defined(__linux__)
+    delete m_ring;
+    if (m_wakeup >= 0) ::close(m_wakeup);
+#endif
+}
+
+void IE::Core::IOService::setQueueDepth(uint32_t t_queueDepth) {
+    m_queueDepth = std::max<uint32_t>(t_queueDepth, 1);
+#if defined(__linux__)
+    if (m_ring != nullptr) {
+        // Let the service thread pick up any requests that the new depth makes room for.
+        uint64_t value{1};
+        (void) write(m_wakeup, &value, sizeof(value));
+    }
+#endif
+}
+
+uint32_t IE::Core::IOService::getQueueDepth() const {
+    return m_queueDepth;
+}
+
+bool IE::Core::IOService::usesIOUring() const {
+#if defined(__linux__)
+    return m_ring != nullptr;
+#else
+    return false;
+#endif
+}
+
+void IE::Core::IOService::submit(IE::Core::IOService::Request *t_request) {
+    std::call_once(m_started, [this] { start(); });
+    bool wasEmpty;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // The destructor takes the lock to collect what is pending after setting m_shutdown, so nothing is missed.
+        if (m_shutdown) return cancel(t_request);
+        wasEmpty = m_pending.empty();
+        m_pending.push_back(t_request);
+    }
+#if defined(__linux__)
+    // Requests that arrive while the service thread is still busy with earlier ones are batched with them.
+    if (m_ring != nullptr) {
+        if (wasEmpty) {
+            uint64_t value{1};
+            (void) write(m_wakeup, &value, sizeof(value));
+        }
+        return;
+    }
+#endif
+    m_condition.notify_one();
+}
+
+void IE::Core::IOService::start() {
+#if defined(__linux__)
+    if (startRing()) {
+        m_threads.emplace_back([this] { runRing(); });
+        return;
+    }
+#endif
+    // Each thread has one read in progress at a time.
+    uint32_t threadCount = std::min(FALLBACK_THREAD_COUNT, m_queueDepth.load());
+    for (uint32_t i{0}; i < threadCount; ++i) m_threads.emplace_back([this] { runFallback(); });
+}
+
+void IE::Core::IOService::runFallback() {
+    Threading::Topology::nameThisThread("IE IO");
+    for (std::unique_lock<std::mutex> lock(m_mutex); !m_shutdown;) {
+        if (m_pending.empty()) {
+            m_condition.wait(lock);
+            continue;
+        }
+        Request *request = m_pending.front();
+        m_pending.pop_front();
+        lock.unlock();
+        read(*request);
+        complete(request);
+        lock.lock();
+    }
+}
+
+void IE::Core::IOService::read(IE::Core::IOService::Request &t_request) {
+#if defined(__linux__) || defined(__APPLE__)
+    // Keep reading until the buffer is full or the end of the file is reached.
+    while (t_request.bytesRead < t_request.length) {
+        ssize_t result = pread(
+          t_request.fileDescriptor,
+          t_request.buffer + t_request.bytesRead,
+          t_request.length - t_request.bytesRead,
+          static_cast<off_t>(t_request.offset + t_request.bytesRead)
+        );
+        if (result < 0 && errno == EINTR) continue;
+        if (result < 0) t_request.error = errno;
+        if (result <= 0) return;
+        t_request.bytesRead += static_cast<std::size_t>(result);
+    }
+#else
+    std::ifstream file{*t_request.path, std::ios::in | std::ios::binary};
+    if (!file.is_open()) {
+        t_request.error = ENOENT;
+        return;
+    }
+    file.seekg(static_cast<std::streamoff>(t_request.offset));
+    file.read(t_request.buffer, static_cast<std::streamsize>(t_request.length));
+    t_request.bytesRead = static_cast<std::size_t>(file.gcount());
+#endif
+}
+
+void IE::Core::IOService::complete(IE::Core::IOService::Request *t_request) {
+    t_request->threadPool->submit(t_request->threadType, t_request->priority, t_request->handle);
+}
+
+void IE::Core::IOService::cancel(IE::Core::IOService::Request *t_request) {
+    t_request->error = ECANCELED;
+    complete(t_request);
+}
+
+#if defined(__linux__)
+bool IE::Core::IOService::startRing() {
+    io_uring_params parameters{};
+    // One more entry than the queue depth, for the read that waits on the wakeup eventfd.
+    int fileDescriptor = static_cast<int>(syscall(__NR_io_uring_setup, m_queueDepth + 1, &parameters));
+    if (fileDescriptor < 0) return false;
+    auto *ring           = new Ring;
+    ring->fileDescriptor = fileDescriptor;
+    ring->entryCount     = parameters.sq_entries;
+    // IORING_OP_READ arrived in the same kernel release as fast polling, which is easier to detect.
+    bool supported       = (parameters.features & IORING_FEAT_FAST_POLL) != 0;
+
+    ring->submissionMemorySize = parameters.sq_off.array + parameters.sq_entries * sizeof(uint32_t);
+    ring->completionMemorySize = parameters.cq_off.cqes + parameters.cq_entries * sizeof(io_uring_cqe);
+    bool singleMapping         = (parameters.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMapping)
+        ring->submissionMemorySize = ring->completionMemorySize =
+          std::max(ring->submissionMemorySize, ring->completionMemorySize);
+    if (supported) {
+        ring->submissionMemory = mmap(
+          nullptr,
+          ring->submissionMemorySize,
+          PROT_READ | PROT_WRITE,
+          MAP_SHARED | MAP_POPULATE,
+          fileDescriptor,
+          IORING_OFF_SQ_RING
+        );
+        ring->completionMemory = singleMapping ? ring->submissionMemory :
+                                                 mmap(
+                                                   nullptr,
+                                                   ring->completionMemorySize,
+                                                   PROT_READ | PROT_WRITE,
+                                                   MAP_SHARED | MAP_POPULATE,
+                                                   fileDescriptor,
+                                                   IORING_OFF_CQ_RING
+                                                 );
+        ring->entries = static_cast<io_uring_sqe *>(mmap(
+          nullptr,
+          parameters.sq_entries * sizeof(io_uring_sqe),
+          PROT_READ | PROT_WRITE,
+          MAP_SHARED | MAP_POPULATE,
+          fileDescriptor,
+          IORING_OFF_SQES
+        ));
+    }
+    m_wakeup = eventfd(0, EFD_CLOEXEC);
+    if (!supported || ring->submissionMemory == MAP_FAILED || ring->completionMemory == MAP_FAILED ||
+        ring->entries == MAP_FAILED || m_wakeup < 0) {
+        delete ring;
+        if (m_wakeup >= 0) ::close(m_wakeup);
+        m_wakeup = -1;
+        return false;
+    }
+
+    auto *submission      = static_cast<char *>(ring->submissionMemory);
+    auto *completion      = static_cast<char *>(ring->completionMemory);
+    ring->submissionTail  = reinterpret_cast<uint32_t *>(submission + parameters.sq_off.tail);
+    ring->submissionMask  = reinterpret_cast<uint32_t *>(submission + parameters.sq_off.ring_mask);
+    ring->submissionArray = reinterpret_cast<uint32_t *>(submission + parameters.sq_off.array);
+    ring->completionHead  = reinterpret_cast<uint32_t *>(completion + parameters.cq_off.head);
+    ring->completionTail  = reinterpret_cast<uint32_t *>(completion + parameters.cq_off.tail);
+    ring->completionMask  = reinterpret_cast<uint32_t *>(completion + parameters.cq_off.ring_mask);
+    ring->completions     = reinterpret_cast<io_uring_cqe *>(completion + parameters.cq_off.cqes);
+    ring->tail            = *ring->submissionTail;
+    m_ring                = ring;
+    return true;
+}
+
+void IE::Core::IOService::runRing() {
+    Threading::Topology::nameThisThread("IE IO");
+    uint64_t wakeupValue;
+    uint32_t inProgress{0};
+    m_ring->prepareRead(m_wakeup, &wakeupValue, sizeof(wakeupValue), NO_OFFSET, WAKEUP_DATA);
+    // The kernel may still write to the buffers of reads in progress, so wait for them before stopping.
+    for (bool shutdown = m_shutdown; !shutdown || inProgress > 0; shutdown = m_shutdown) {
+        // Move as many pending requests into the ring as the queue depth allows, then submit them all at once.
+        if (!shutdown) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            uint32_t depth = std::min(m_queueDepth.load(), m_ring->entryCount - 1);
+            while (!m_pending.empty() && inProgress < depth) {
+                Request *request = m_pending.front();
+                m_pending.pop_front();
+                // Reads larger than the kernel accepts at once are finished off as short reads below.
+                m_ring->prepareRead(
+                  request->fileDescriptor,
+                  request->buffer + request->bytesRead,
+                  static_cast<uint32_t>(std::min<std::size_t>(request->length - request->bytesRead, 1u << 30)),
+                  request->offset + request->bytesRead,
+                  reinterpret_cast<uint64_t>(request)
+                );
+                ++inProgress;
+            }
+        }
+        m_ring->enter();
+
+        uint32_t head = *m_ring->completionHead;
+        uint32_t tail = __atomic_load_n(m_ring->completionTail, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head) {
+            const io_uring_cqe &completion = m_ring->completions[head & *m_ring->completionMask];
+            if (completion.user_data == WAKEUP_DATA) {
+                m_ring->prepareRead(m_wakeup, &wakeupValue, sizeof(wakeupValue), NO_OFFSET, WAKEUP_DATA);
+                continue;
+            }
+            auto *request = reinterpret_cast<Request *>(completion.user_data);
+            --inProgress;
+            if (shutdown) {
+                cancel(request);
+                continue;
+            }
+            if (completion.res < 0) request->error = -completion.res;
+            else request->bytesRead += static_cast<std::size_t>(completion.res);
+            // A read can come back short before the end of the file, in which case the rest is read separately.
+            if (completion.res > 0 && request->bytesRead < request->length) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_pending.push_front(request);
+                continue;
+            }
+            complete(request);
+        }
+        __atomic_store_n(m_ring->completionHead, head, __ATOMIC_RELEASE);
+    }
+}
+#endif
+
+IE::Core::FileDescriptor::FileDescriptor([[maybe_unused]] const std::filesystem::path &t_path) {
+#if defined(__linux__) || defined(__APPLE__)
+    m_descriptor = ::open(t_path.c_str(), O_RDONLY | O_CLOEXEC);
+#endif
+}
+
+IE::Core::FileDescriptor::~FileDescriptor() {
+#if defined(__linux__) || defined(__APPLE__)
+    if (m_descriptor >= 0) ::close(m_descriptor);
+#endif
+}
+
+int IE::Core::FileDescriptor::get() const {
+    return m_descriptor;
+}
+
+IE::Core::AsyncRead::AsyncRead(
+  IE::Core::Threading::ThreadPool                *t_threadPool,
+  std::shared_ptr<const IE::Core::FileDescriptor> t_descriptor,
+  const std::filesystem::path                    *t_path,
+  std::streamsize                                 t_offset,
+  std::streamsize                                 t_length,
+  char                                           *t_buffer
+) :
+        m_descriptor(std::move(t_descriptor)),
+        m_request{
+          .fileDescriptor = m_descriptor->get(),
+          .path           = t_path,
+          .offset         = static_cast<uint64_t>(std::max<std::streamsize>(t_offset, 0)),
+          .length         = static_cast<std::size_t>(std::max<std::streamsize>(t_length, 0)),
+          .buffer         = t_buffer,
+          .threadPool     = t_threadPool,
+          .handle         = nullptr,
+          .threadType     = t_threadPool->thisThreadType(),
+          .priority       = Threading::Worker::currentPriority()} {
+#if defined(__linux__) || defined(__APPLE__)
+    if (m_request.fileDescriptor < 0) m_request.error = EBADF;
+#endif
+}
+
+IE::Core::AsyncRead::AsyncRead(std::streamsize t_bytesRead) :
+        m_request{
+          .fileDescriptor = -1,
+          .path           = nullptr,
+          .offset         = 0,
+          .length         = static_cast<std::size_t>(t_bytesRead),
+          .buffer         = nullptr,
+          .bytesRead      = static_cast<std::size_t>(t_bytesRead),
+          .threadPool     = nullptr,
+          .handle         = nullptr,
+          .threadType     = Threading::IE_THREAD_TYPE_WORKER_THREAD,
+          .priority       = Threading::IE_TASK_PRIORITY_NORMAL} {
+}
+
+bool IE::Core::AsyncRead::await_ready() {
+    return m_request.bytesRead == m_request.length || m_request.error != 0;
+}
+
+std::coroutine_handle<> IE::Core::AsyncRead::await_suspend(std::coroutine_handle<> t_handle) {
+    m_request.handle = t_handle;
+    // The coroutine may be resumed on another thread before this returns, so nothing may touch the request now.
+    IOService::get().submit(&m_request);
+    return std::noop_coroutine();
+}
+
+std::streamsize IE::Core::AsyncRead::await_resume() {
+    if (m_request.error != 0)
+        throw std::runtime_error(
+          "failed to read from file: " + (m_request.path != nullptr ? m_request.path->string() + ": " : "") +
+          std::strerror(m_request.error)
+        );
+    return static_cast<std::streamsize>(m_request.bytesRead);
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "Core/ThreadingModule/Awaitable.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <ios>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace IE::Core::Threading {
+class ThreadPool;
+}  // namespace IE::Core::Threading
+
+namespace IE::Core {
+/**
+ * @brief Reads files in the background, resuming the coroutines that asked for them on a thread pool.
+ * @details On Linux, reads are handed to the kernel in batches through an io_uring, and a single service thread
+ * collects their completions. Everywhere else, and on kernels without io_uring, a few service threads of its own
+ * make blocking reads instead, so that the workers of the thread pool are never held while the disk is busy.
+ */
+class IOService {
+public:
+    /// The default number of reads that may be in progress at once.
+    static constexpr uint32_t DEFAULT_QUEUE_DEPTH{64};
+    /// The number of threads that make blocking reads when io_uring is unavailable.
+    static constexpr uint32_t FALLBACK_THREAD_COUNT{4};
+
+    /** A read in progress. Lives in the awaiting coroutine's frame until it is resumed. */
+    struct Request {
+        int                          fileDescriptor;
+        const std::filesystem::path *path;  // Only used on platforms without pread.
+        uint64_t                     offset;
+        std::size_t                  length;
+        char                        *buffer;
+        std::size_t                  bytesRead{0};
+        int                          error{0};  // An errno value, or 0 on success.
+        Threading::ThreadPool       *threadPool;
+        std::coroutine_handle<>      handle;
+        Threading::ThreadType        threadType;
+        Threading::TaskPriority      priority;
+    };
+
+    static IOService &get();
+
+    IOService(const IOService &) = delete;
+
+    IOService &operator=(const IOService &) = delete;
+
+    /**
+     * @brief Stop the service threads.
+     * @details Reads that the kernel has already been given are waited for. Every read that has not finished is
+     * then completed with ECANCELED, so that the coroutines waiting on them resume and their co_await throws.
+     */
+    ~IOService();
+
+    /**
+     * @brief Set the number of reads that may be in progress at once.
+     * @details The io_uring is sized when the first read is submitted, so a larger depth set after that is limited
+     * to the size that it was created with.
+     */
+    void setQueueDepth(uint32_t t_queueDepth);
+
+    [[nodiscard]] uint32_t getQueueDepth() const;
+
+    /** @return True if reads go through io_uring. Only meaningful once the first read has been submitted. */
+    [[nodiscard]] bool usesIOUring() const;
+
+    /**
+     * @brief Start t_request. Its coroutine is submitted to its thread pool once the read has finished.
+     * @details Once the service is shutting down, t_request is cancelled straight away.
+     */
+    void submit(Request *t_request);
+
+private:
+    std::mutex               m_mutex;
+    std::condition_variable  m_condition;
+    std::deque<Request *>    m_pending;
+    std::atomic<uint32_t>    m_queueDepth{DEFAULT_QUEUE_DEPTH};
+    std::atomic<bool>        m_shutdown{false};
+    std::once_flag           m_started;
+    std::vector<std::thread> m_threads;
+#if defined(__linux__)
+    struct Ring;
+
+    Ring *m_ring{nullptr};
+    int   m_wakeup{-1};  // An eventfd, read through the ring so that new work interrupts the wait for completions.
+#endif
+
+    IOService() = default;
+
+    void start();
+
+    void runFallback();
+
+    /** Make one blocking read for t_request, filling in its result. */
+    static void read(Request &t_request);
+
+    static void complete(Request *t_request);
+
+    /** Complete t_request with ECANCELED, without reading anything more. */
+    static void cancel(Request *t_request);
+
+#if defined(__linux__)
+    bool startRing();
+
+    void runRing();
+#endif
+};
+
+/**
+ * @brief A file opened for asynchronous reads.
+ * @details Every read that is in progress holds a reference to it, so the file is closed as soon as the last of
+ * them has finished rather than staying open while nothing reads from it.
+ */
+class FileDescriptor {
+public:
+    /** Open t_path for reading. get() returns -1 if it could not be opened. */
+    explicit FileDescriptor(const std::filesystem::path &t_path);
+
+    FileDescriptor(const FileDescriptor &) = delete;
+
+    FileDescriptor &operator=(const FileDescriptor &) = delete;
+
+    ~FileDescriptor();
+
+    [[nodiscard]] int get() const;
+
+private:
+    int m_descriptor{-1};
+};
+
+/** Suspends the awaiting coroutine until a read from a file has finished, without holding a worker. */
+class AsyncRead {
+public:
+    AsyncRead(
+      Threading::ThreadPool                *t_threadPool,
+      std::shared_ptr<const FileDescriptor> t_descriptor,
+      const std::filesystem::path          *t_path,
+      std::streamsize                       t_offset,
+      std::streamsize                       t_length,
+      char                                 *t_buffer
+    );
+
+    /** A read of t_bytesRead bytes that has already been made, such as from a file in memory. Never suspends. */
+    explicit AsyncRead(std::streamsize t_bytesRead);
+
+    bool await_ready();
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> t_handle);
+
+    /** @return The number of bytes read, which is only less than requested at the end of the file. */
+    std::streamsize await_resume();
+
+private:
+    // Keeps the file open until the read has finished.
+    std::shared_ptr<const FileDescriptor> m_descriptor;
+    IOService::Request                    m_request;
+};
+}  // namespace IE::Core
@@ -1,16 +1,112 @@
 #include "Importer.hpp"
 
 #include "File.hpp"
+#include "FileSystem.hpp"
 
+#include <assimp/IOSystem.hpp>
+#include <assimp/MemoryIOWrapper.h>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
 
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <string_view>
+
+namespace {
+// Formats that never refer to other files, and can therefore be parsed from memory.
+constexpr std::array<std::string_view, 6> SELF_CONTAINED_EXTENSIONS{
+  ".glb",
+  ".fbx",
+  ".ply",
+  ".stl",
+  ".3ds",
+  ".blend"};
+
+/** Reads from a mapping, which it keeps alive for as long as Assimp holds the stream. */
+class MappedIOStream : public Assimp::MemoryIOStream {
+public:
+    explicit MappedIOStream(IE::Core::FileMapping t_mapping) :
+            Assimp::MemoryIOStream(
+              reinterpret_cast<const uint8_t *>(t_mapping.bytes().data()),
+              t_mapping.bytes().size()
+            ),
+            m_mapping(std::move(t_mapping)) {
+    }
+
+private:
+    IE::Core::FileMapping m_mapping;
+};
+
+/** Lets Assimp open the files that a scene refers to through a FileSystem, so that they may come from packs. */
+class FileSystemIOSystem : public Assimp::IOSystem {
+public:
+    explicit FileSystemIOSystem(IE::Core::FileSystem &t_fileSystem) : m_fileSystem(t_fileSystem) {
+    }
+
+    bool Exists(const char *t_path) const override {
+        return m_fileSystem.getFile(t_path) != nullptr;
+    }
+
+    char getOsSeparator() const override {
+        return '/';
+    }
+
+    Assimp::IOStream *Open(const char *t_path, const char *t_mode) override {
+        // Nothing is ever written while importing, and packs can not be written to.
+        if (std::string_view(t_mode).find_first_of("wa+") != std::string_view::npos) return nullptr;
+        IE::Core::FileMapping mapping = m_fileSystem.mapFile(t_path);
+        return mapping.valid() ? new MappedIOStream(std::move(mapping)) : nullptr;
+    }
+
+    void Close(Assimp::IOStream *t_stream) override {
+        delete t_stream;
+    }
+
+private:
+    IE::Core::FileSystem &m_fileSystem;
+};
+}  // namespace
+
+const aiScene *IE::Core::Importer::readScene(
+  Assimp::Importer     &t_importer,
+  IE::Core::File       &t_file,
+  uint32_t              t_flags,
+  IE::Core::FileSystem *t_fileSystem
+) {
+    std::string extension = t_file.extension;
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char t_character) {
+        return std::tolower(t_character);
+    });
+    if (std::find(SELF_CONTAINED_EXTENSIONS.begin(), SELF_CONTAINED_EXTENSIONS.end(), extension) ==
+        SELF_CONTAINED_EXTENSIONS.end()) {
+        if (t_fileSystem == nullptr) return t_importer.ReadFile(t_file.path.string().c_str(), t_flags);
+        // The importer deletes whatever IO system it still has when destroyed, but gives this one up once it is
+        // handed nullptr, which switches it back to its default one.
+        FileSystemIOSystem ioSystem(*t_fileSystem);
+        t_importer.SetIOHandler(&ioSystem);
+        const aiScene *scene = t_importer.ReadFile(t_file.path.string().c_str(), t_flags);
+        t_importer.SetIOHandler(nullptr);
+        return scene;
+    }
+    // Assimp copies what it needs into the scene, so the mapping only has to outlive the call.
+    FileMapping mapping = t_file.map(IE_ACCESS_PATTERN_SEQUENTIAL);
+    if (!mapping.valid() || mapping.bytes().empty()) return nullptr;
+    return t_importer.ReadFileFromMemory(
+      mapping.bytes().data(),
+      mapping.bytes().size(),
+      t_flags,
+      extension.c_str() + 1  // Assimp wants the extension without its dot.
+    );
+}
+
 void IE::Core::Importer::import(const aiScene **scene, IE::Core::File &file, unsigned int flags = 0) {
-    *scene = importer.ReadFile(file.path.string().c_str(), flags);
+    *scene = readScene(importer, file, flags);
     if (!(*scene) || (*scene)->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !(*scene)->mRootNode)
         throw std::runtime_error("failed to prepare scene from file: " + file.path.string());
 }
 
 void IE::Core::Importer::import(std::string *string, IE::Core::File &file, unsigned int flags = 0) {
-    string->assign(file.read().data(), file.size);
+    FileMapping mapping = file.map(IE_ACCESS_PATTERN_SEQUENTIAL);
+    string->assign(reinterpret_cast<const char *>(mapping.bytes().data()), mapping.bytes().size());
 }
@@ -10,10 +10,27 @@ class IETexture;
  * A class used to import files into a program. One per filesystem.
  */
 namespace IE::Core {
+class FileSystem;
+
 class Importer {
 public:
     Assimp::Importer importer{};
 
+    /**
+     * @brief Read a scene with t_importer, from a memory mapping of t_file where possible.
+     * @details Formats that keep everything in one file are parsed straight from the mapped bytes. Formats that
+     * may refer to other files, such as OBJ with its MTL, are read by path so that Assimp can find them. Those
+     * paths are looked up through t_fileSystem if it is given, so that files in mounted packs are found too, and
+     * through the operating system otherwise.
+     * @return The scene, which t_importer owns, or nullptr on failure.
+     */
+    static const aiScene *readScene(
+      Assimp::Importer &t_importer,
+      File             &t_file,
+      uint32_t          t_flags,
+      FileSystem       *t_fileSystem = nullptr
+    );
+
     void import(const aiScene **, File &, uint32_t);
 
     static void import(std::string *, File &, uint32_t);
@@ -0,0 +1,162 @@
+#include "Pack.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static_assert(std::endian::native == std::endian::little, "packs are stored little-endian");
+
+struct IE::Core::Pack::Header {
+    char     magic[4];
+    uint32_t version;
+    uint64_t entryCount;
+    uint64_t slotCount;  // Always a power of two.
+    uint64_t slotsOffset;
+    uint64_t stringsOffset;
+    uint64_t stringsSize;
+};
+
+/** One slot of the open-addressed table of contents. Colliding paths go in the following slots. */
+struct IE::Core::Pack::Slot {
+    uint64_t hash;  // 0 if the slot is empty.
+    uint64_t offset;
+    uint64_t size;
+    uint32_t pathOffset;  // Into the strings that follow the slots.
+    uint32_t pathLength;
+};
+
+namespace {
+constexpr char MAGIC[4]{'I', 'E', 'P', 'K'};
+
+uint64_t alignUp(uint64_t t_value, uint64_t t_alignment) {
+    return (t_value + t_alignment - 1) / t_alignment * t_alignment;
+}
+}  // namespace
+
+IE::Core::Pack::Pack(const std::filesystem::path &t_path) {
+    // The mapping keeps the pack mapped once the file is gone. It sizes the pack itself, so the pack is only opened
+    // by map().
+    m_mapping = File{t_path, 0}.map(IE_ACCESS_PATTERN_RANDOM);
+    std::span<const std::byte> bytes = m_mapping.bytes();
+    auto                       fail  = [&] { throw std::runtime_error("invalid pack file: " + t_path.string()); };
+    if (!m_mapping.valid() || bytes.size() < sizeof(Header)) fail();
+
+    Header header{};
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION) fail();
+    if (!std::has_single_bit(header.slotCount) || header.slotsOffset % alignof(Slot) != 0) fail();
+    if (header.slotsOffset > bytes.size() || header.slotCount > (bytes.size() - header.slotsOffset) / sizeof(Slot))
+        fail();
+    if (header.stringsOffset > bytes.size() || header.stringsSize > bytes.size() - header.stringsOffset) fail();
+    m_slots      = reinterpret_cast<const Slot *>(bytes.data() + header.slotsOffset);
+    m_slotMask   = header.slotCount - 1;
+    m_entryCount = header.entryCount;
+    m_strings    = reinterpret_cast<const char *>(bytes.data() + header.stringsOffset);
+
+    // Check every slot once up front, so that lookups can trust them.
+    uint64_t usedSlotCount{0};
+    for (uint64_t i{0}; i < header.slotCount; ++i) {
+        const Slot &slot = m_slots[i];
+        if (slot.hash == 0) continue;
+        if (slot.offset > bytes.size() || slot.size > bytes.size() - slot.offset) fail();
+        if (slot.pathOffset > header.stringsSize || slot.pathLength > header.stringsSize - slot.pathOffset) fail();
+        ++usedSlotCount;
+    }
+    // Lookups stop at the first empty slot, so there must be one.
+    if (usedSlotCount >= header.slotCount) fail();
+}
+
+std::optional<IE::Core::FileMapping> IE::Core::Pack::find(std::string_view t_path) const {
+    uint64_t hash = Pack::hash(t_path);
+    // The table is never full, so there is always an empty slot to stop at.
+    for (uint64_t i = hash & m_slotMask;; i = (i + 1) & m_slotMask) {
+        const Slot &slot = m_slots[i];
+        if (slot.hash == 0) return std::nullopt;
+        if (slot.hash == hash && std::string_view{m_strings + slot.pathOffset, slot.pathLength} == t_path)
+            return m_mapping.slice(slot.offset, slot.size);
+    }
+}
+
+uint64_t IE::Core::Pack::size() const {
+    return m_entryCount;
+}
+
+uint64_t IE::Core::Pack::build(const std::filesystem::path &t_directory, const std::filesystem::path &t_output) {
+    std::vector<std::filesystem::path> paths;
+    std::filesystem::path              output = std::filesystem::weakly_canonical(t_output);
+    for (const auto &entry : std::filesystem::recursive_directory_iterator{t_directory})
+        if (entry.is_regular_file() && std::filesystem::weakly_canonical(entry.path()) != output)
+            paths.push_back(entry.path());
+    // Sort so that the same directory always produces the same pack.
+    std::sort(paths.begin(), paths.end());
+
+    std::ofstream pack{t_output, std::ios::out | std::ios::binary | std::ios::trunc};
+    if (!pack.is_open()) throw std::runtime_error("failed to open pack for writing: " + t_output.string());
+    auto pad = [&](uint64_t t_alignment) {
+        uint64_t position = pack.tellp();
+        for (uint64_t i = position; i < alignUp(position, t_alignment); ++i) pack.put('\0');
+    };
+
+    // Write the contents first, remembering where each file went.
+    Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version    = VERSION;
+    header.entryCount = paths.size();
+    pack.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    std::vector<Slot> entries;
+    std::string       strings;
+    entries.reserve(paths.size());
+    for (const std::filesystem::path &path : paths) {
+        std::string relativePath = path.lexically_relative(t_directory).generic_string();
+        std::ifstream input{path, std::ios::in | std::ios::binary};
+        if (!input.is_open()) throw std::runtime_error("failed to open file for packing: " + path.string());
+        pad(BLOB_ALIGNMENT);
+        auto offset = static_cast<uint64_t>(pack.tellp());
+        // Streaming an empty file would fail the pack.
+        if (std::filesystem::file_size(path) > 0) pack << input.rdbuf();
+        entries.push_back(Slot{
+          .hash       = hash(relativePath),
+          .offset     = offset,
+          .size       = static_cast<uint64_t>(pack.tellp()) - offset,
+          .pathOffset = static_cast<uint32_t>(strings.size()),
+          .pathLength = static_cast<uint32_t>(relativePath.size())});
+        strings += relativePath;
+    }
+    if (strings.size() > UINT32_MAX) throw std::runtime_error("too many paths to pack: " + t_directory.string());
+
+    // Keep the table at most half full, so that probe sequences stay short.
+    header.slotCount = std::bit_ceil(std::max<uint64_t>(paths.size() * 2, 1));
+    std::vector<Slot> slots(header.slotCount);
+    for (const Slot &entry : entries) {
+        uint64_t i = entry.hash & (header.slotCount - 1);
+        while (slots[i].hash != 0) i = (i + 1) & (header.slotCount - 1);
+        slots[i] = entry;
+    }
+    pad(alignof(Slot));
+    header.slotsOffset = pack.tellp();
+    pack.write(
+      reinterpret_cast<const char *>(slots.data()),
+      static_cast<std::streamsize>(slots.size() * sizeof(Slot))
+    );
+    header.stringsOffset = pack.tellp();
+    header.stringsSize   = strings.size();
+    pack.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+
+    pack.seekp(0);
+    pack.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    if (!pack) throw std::runtime_error("failed to write pack: " + t_output.string());
+    return paths.size();
+}
+
+uint64_t IE::Core::Pack::hash(std::string_view t_path) {
+    uint64_t hash{14695981039346656037ULL};
+    for (char character : t_path) {
+        hash ^= static_cast<unsigned char>(character);
+        hash *= 1099511628211ULL;
+    }
+    return hash != 0 ? hash : 1;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "File.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+
+namespace IE::Core {
+/**
+ * @brief A read-only archive of many files, mapped into memory as a whole.
+ * @details A pack starts with a header, followed by the contents of each file, then a hash table of their paths
+ * and the paths themselves. Contents are aligned to BLOB_ALIGNMENT bytes, so that they can be used straight out
+ * of the mapping. Looking a file up hashes its path and probes the table in the mapping, without touching the disk
+ * or the heap. All integers are stored little-endian, and paths are relative to the packed directory, separated
+ * by '/'.
+ */
+class Pack {
+public:
+    static constexpr uint32_t VERSION{1};
+    static constexpr uint64_t BLOB_ALIGNMENT{64};
+
+    /** Map the pack at t_path. Throws std::runtime_error if it can not be mapped or is not a valid pack. */
+    explicit Pack(const std::filesystem::path &t_path);
+
+    /** @return The contents of the file at t_path, which keep the pack mapped, or nothing if it is not packed. */
+    [[nodiscard]] std::optional<FileMapping> find(std::string_view t_path) const;
+
+    [[nodiscard]] uint64_t size() const;
+
+    /**
+     * @brief Pack every file below t_directory into a new pack at t_output, replacing it if it already exists.
+     * @return The number of files packed. Throws std::runtime_error if anything can not be read or written.
+     */
+    static uint64_t build(const std::filesystem::path &t_directory, const std::filesystem::path &t_output);
+
+    /** The 64-bit FNV-1a hash of t_path. Never 0, which marks an empty slot. */
+    static uint64_t hash(std::string_view t_path);
+
+private:
+    struct Header;
+    struct Slot;
+
+    FileMapping m_mapping;
+    const Slot *m_slots{};
+    uint64_t    m_slotMask{};
+    uint64_t    m_entryCount{};
+    const char *m_strings{};
+};
+}  // namespace IE::Core
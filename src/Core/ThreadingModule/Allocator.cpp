@@ -0,0 +1,127 @@
+#include "Allocator.hpp"
+
+#include <algorithm>
+#include <mutex>
+
+namespace {
+using IE::Core::Threading::detail::FreeBlock;
+using IE::Core::Threading::detail::ThreadCache;
+
+struct DepotBucket {
+    std::mutex mutex;
+    FreeBlock *head{};
+};
+
+// Blocks can be freed during static destruction (e.g. by a static ThreadPool dropping its queued tasks), so the
+// depot is intentionally never destroyed.
+std::array<DepotBucket, ThreadCache::SIZE_CLASS_COUNT> &depot() {
+    static auto *depot = new std::array<DepotBucket, ThreadCache::SIZE_CLASS_COUNT>{};
+    return *depot;
+}
+
+// Set once the calling thread's cache has been destroyed. Any later requests on this thread go to the depot.
+thread_local bool threadCacheDestroyed{false};
+
+std::size_t sizeClassOf(std::size_t t_size) {
+    return (std::max<std::size_t>(t_size, 1) - 1) / ThreadCache::SIZE_CLASS_GRANULARITY;
+}
+
+std::size_t blockSizeOf(std::size_t t_sizeClass) {
+    return (t_sizeClass + 1) * ThreadCache::SIZE_CLASS_GRANULARITY;
+}
+
+void pushToDepot(std::size_t t_sizeClass, FreeBlock *t_block) {
+    DepotBucket                &bucket = depot()[t_sizeClass];
+    std::lock_guard<std::mutex> lock(bucket.mutex);
+    t_block->next = bucket.head;
+    bucket.head   = t_block;
+}
+
+FreeBlock *carveSlab(std::size_t t_sizeClass) {
+    std::size_t blockSize  = blockSizeOf(t_sizeClass);
+    std::size_t blockCount = std::max<std::size_t>(ThreadCache::SLAB_SIZE / blockSize, 1);
+    auto       *slab       = static_cast<std::byte *>(::operator new(blockSize * blockCount));
+    FreeBlock  *head{};
+    for (std::size_t i{blockCount}; i > 0; --i) {
+        auto *block = reinterpret_cast<FreeBlock *>(slab + (i - 1) * blockSize);
+        block->next = head;
+        head        = block;
+    }
+    return head;
+}
+}  // namespace
+
+void *IE::Core::Threading::detail::ThreadCache::allocate(std::size_t t_size) {
+    if (t_size > MAX_POOLED_SIZE) return ::operator new(t_size);
+    std::size_t sizeClass = sizeClassOf(t_size);
+    if (threadCacheDestroyed) {
+        DepotBucket                &depotBucket = depot()[sizeClass];
+        std::lock_guard<std::mutex> lock(depotBucket.mutex);
+        if (depotBucket.head == nullptr) depotBucket.head = carveSlab(sizeClass);
+        FreeBlock *block = depotBucket.head;
+        depotBucket.head = block->next;
+        return block;
+    }
+    ThreadCache &cache  = get();
+    Bucket      &bucket = cache.m_buckets[sizeClass];
+    if (bucket.head == nullptr) cache.refill(sizeClass);
+    FreeBlock *block = bucket.head;
+    bucket.head      = block->next;
+    --bucket.count;
+    return block;
+}
+
+void IE::Core::Threading::detail::ThreadCache::deallocate(void *t_pointer, std::size_t t_size) noexcept {
+    if (t_pointer == nullptr) return;
+    if (t_size > MAX_POOLED_SIZE) return ::operator delete(t_pointer, t_size);
+    std::size_t sizeClass = sizeClassOf(t_size);
+    auto       *block     = static_cast<FreeBlock *>(t_pointer);
+    if (threadCacheDestroyed) return pushToDepot(sizeClass, block);
+    ThreadCache &cache  = get();
+    Bucket      &bucket = cache.m_buckets[sizeClass];
+    block->next         = bucket.head;
+    bucket.head         = block;
+    if (++bucket.count > MAX_CACHED_BLOCKS) cache.drain(sizeClass, TRANSFER_BATCH_SIZE);
+}
+
+IE::Core::Threading::detail::ThreadCache::~ThreadCache() {
+    for (std::size_t sizeClass{0}; sizeClass < SIZE_CLASS_COUNT; ++sizeClass)
+        drain(sizeClass, m_buckets[sizeClass].count);
+    threadCacheDestroyed = true;
+}
+
+IE::Core::Threading::detail::ThreadCache &IE::Core::Threading::detail::ThreadCache::get() {
+    thread_local ThreadCache cache;
+    return cache;
+}
+
+void IE::Core::Threading::detail::ThreadCache::refill(std::size_t t_sizeClass) {
+    Bucket      &bucket      = m_buckets[t_sizeClass];
+    DepotBucket &depotBucket = depot()[t_sizeClass];
+    {
+        std::lock_guard<std::mutex> lock(depotBucket.mutex);
+        for (; depotBucket.head != nullptr && bucket.count < TRANSFER_BATCH_SIZE; ++bucket.count) {
+            FreeBlock *block = depotBucket.head;
+            depotBucket.head = block->next;
+            block->next      = bucket.head;
+            bucket.head      = block;
+        }
+    }
+    if (bucket.head != nullptr) return;
+
+    // The depot is empty as well, so carve a new slab into blocks for this thread.
+    bucket.head = carveSlab(t_sizeClass);
+    for (FreeBlock *block = bucket.head; block != nullptr; block = block->next) ++bucket.count;
+}
+
+void IE::Core::Threading::detail::ThreadCache::drain(std::size_t t_sizeClass, std::size_t t_count) {
+    Bucket                     &bucket      = m_buckets[t_sizeClass];
+    DepotBucket                &depotBucket = depot()[t_sizeClass];
+    std::lock_guard<std::mutex> lock(depotBucket.mutex);
+    for (; bucket.head != nullptr && t_count > 0; --t_count, --bucket.count) {
+        FreeBlock *block = bucket.head;
+        bucket.head      = block->next;
+        block->next      = depotBucket.head;
+        depotBucket.head = block;
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <new>
+
+namespace IE::Core::Threading {
+namespace detail {
+struct FreeBlock {
+    FreeBlock *next;
+};
+
+/**
+ * @brief A per-thread cache of fixed size memory blocks used for tasks and their coroutine frames.
+ * @details Requests are rounded up to a size class. Each thread keeps a free list per size class, refilled from a
+ * global depot or by carving a new slab. Blocks may be freed on a different thread from the one that allocated
+ * them; they simply join the freeing thread's cache. When a thread's cache grows too large, or when the thread
+ * exits, its blocks are handed back to the depot. Slabs are never returned to the system.
+ */
+class ThreadCache {
+public:
+    static constexpr std::size_t SIZE_CLASS_GRANULARITY{64};
+    static constexpr std::size_t SIZE_CLASS_COUNT{32};  // Blocks of up to 2 KiB are pooled.
+    static constexpr std::size_t MAX_POOLED_SIZE{SIZE_CLASS_GRANULARITY * SIZE_CLASS_COUNT};
+    static constexpr std::size_t SLAB_SIZE{16384};
+    static constexpr std::size_t MAX_CACHED_BLOCKS{256};  // Per size class.
+    static constexpr std::size_t TRANSFER_BATCH_SIZE{MAX_CACHED_BLOCKS / 2};
+
+    static void *allocate(std::size_t t_size);
+
+    static void deallocate(void *t_pointer, std::size_t t_size) noexcept;
+
+    ~ThreadCache();
+
+private:
+    struct Bucket {
+        FreeBlock  *head{};
+        std::size_t count{};
+    };
+
+    std::array<Bucket, SIZE_CLASS_COUNT> m_buckets{};
+
+    static ThreadCache &get();
+
+    void refill(std::size_t t_sizeClass);
+
+    void drain(std::size_t t_sizeClass, std::size_t t_count);
+};
+}  // namespace detail
+
+/**
+ * @brief A standard allocator that draws from the per-thread task pool.
+ * @details Used with std::allocate_shared so that a task and its shared_ptr control block share one pooled block.
+ */
+template<typename T>
+class PoolAllocator {
+public:
+    using value_type = T;
+
+    PoolAllocator() = default;
+
+    template<typename U>
+    PoolAllocator(const PoolAllocator<U> &) noexcept {
+    }
+
+    T *allocate(std::size_t t_count) {
+        if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+            return static_cast<T *>(::operator new(t_count * sizeof(T), std::align_val_t{alignof(T)}));
+        return static_cast<T *>(detail::ThreadCache::allocate(t_count * sizeof(T)));
+    }
+
+    void deallocate(T *t_pointer, std::size_t t_count) noexcept {
+        if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+            return ::operator delete(t_pointer, t_count * sizeof(T), std::align_val_t{alignof(T)});
+        detail::ThreadCache::deallocate(t_pointer, t_count * sizeof(T));
+    }
+
+    template<typename U>
+    bool operator==(const PoolAllocator<U> &) const noexcept {
+        return true;
+    }
+};
+}  // namespace IE::Core::Threading
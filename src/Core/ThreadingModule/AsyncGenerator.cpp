@@ -0,0 +1 @@
+#include "AsyncGenerator.hpp"
@@ -0,0 +1,267 @@
+#pragma once
+
+#include "Allocator.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+namespace IE::Core::Threading {
+/**
+ * @brief A coroutine that co_yields items one at a time for another coroutine to co_await as they become ready.
+ * @details Once started, the producer runs on the thread pool, concurrently with its consumer. Yielded items
+ * wait in a buffer of a fixed capacity. The producer is suspended whenever the buffer is full, and only resumed
+ * once the consumer has taken an item out, so a slow consumer holds back its producer instead of letting items
+ * pile up. The consumer awaits next(), which gives an empty optional once the producer has returned:
+ *
+ *     AsyncGenerator<Mesh> meshes = importMeshes(scene);
+ *     meshes.start(threadPool, IE_THREAD_TYPE_WORKER_THREAD, 4);
+ *     while (std::optional<Mesh> mesh = co_await meshes.next()) upload(*mesh);
+ *
+ * An exception thrown by the producer is rethrown from next() after the items yielded before it. The generator
+ * may be destroyed at any time, except while its consumer is waiting on it. A producer that is still running then
+ * frees itself the next time that it yields.
+ */
+template<typename T>
+class AsyncGenerator {
+public:
+    struct promise_type;
+
+    using Handle = std::coroutine_handle<promise_type>;
+
+    /** Suspends the producer at a co_yield while the buffer is full. */
+    struct YieldAwaiter {
+        promise_type &promise;
+        bool          full;
+
+        bool await_ready() noexcept {
+            return !full;
+        }
+
+        std::coroutine_handle<> await_suspend(Handle t_handle) noexcept {
+            std::unique_lock<std::mutex> lock(promise.mutex);
+            if (promise.detached) {
+                lock.unlock();
+                t_handle.destroy();
+                return std::noop_coroutine();
+            }
+            // The consumer may have made room in the meantime.
+            if (promise.items.size() < promise.capacity) return t_handle;
+            // Once the lock is released the consumer may resume the producer on another thread, so nothing may
+            // touch this awaiter after this.
+            promise.running = false;
+            return std::noop_coroutine();
+        }
+
+        void await_resume() noexcept {
+        }
+    };
+
+    /** Wakes the consumer once the producer has returned, and frees a producer that outlived its generator. */
+    struct FinalAwaiter {
+        promise_type &promise;
+
+        bool await_ready() noexcept {
+            return false;
+        }
+
+        void await_suspend(Handle t_handle) noexcept {
+            std::coroutine_handle<> consumer;
+            ThreadType              consumerThreadType;
+            ThreadPool             *threadPool;
+            bool                    detached;
+            {
+                std::lock_guard<std::mutex> lock(promise.mutex);
+                promise.done       = true;
+                promise.running    = false;
+                consumer           = std::exchange(promise.consumer, nullptr);
+                consumerThreadType = promise.consumerThreadType;
+                threadPool         = promise.threadPool;
+                detached           = promise.detached;
+            }
+            // Unless it is detached, the generator may destroy the frame as soon as the lock is released.
+            if (consumer) threadPool->submit(consumerThreadType, consumer);
+            if (detached) t_handle.destroy();
+        }
+
+        void await_resume() noexcept {
+        }
+    };
+
+    struct promise_type {
+        std::mutex              mutex;
+        std::deque<T>           items;
+        std::size_t             capacity{1};
+        ThreadPool             *threadPool{};
+        ThreadType              threadType{IE_THREAD_TYPE_WORKER_THREAD};
+        // The consumer, while it waits for an item.
+        std::coroutine_handle<> consumer;
+        ThreadType              consumerThreadType{IE_THREAD_TYPE_WORKER_THREAD};
+        // True while the producer is submitted or executing, as opposed to suspended.
+        bool                    running{false};
+        bool                    done{false};
+        // Set when the generator is destroyed while the producer is running, leaving the producer to free itself.
+        bool                    detached{false};
+        std::exception_ptr      exception;
+
+        // Coroutine frames come from the per-thread task pool rather than the global heap.
+        static void *operator new(std::size_t t_size) {
+            return detail::ThreadCache::allocate(t_size);
+        }
+
+        static void operator delete(void *t_pointer, std::size_t t_size) noexcept {
+            detail::ThreadCache::deallocate(t_pointer, t_size);
+        }
+
+        AsyncGenerator get_return_object() {
+            return AsyncGenerator{Handle::from_promise(*this)};
+        }
+
+        std::suspend_always initial_suspend() noexcept {
+            return {};
+        }
+
+        FinalAwaiter final_suspend() noexcept {
+            return {*this};
+        }
+
+        YieldAwaiter yield_value(T t_value) {
+            std::coroutine_handle<> waitingConsumer;
+            bool                    full;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                items.push_back(std::move(t_value));
+                waitingConsumer = std::exchange(consumer, nullptr);
+                // A detached producer suspends so that it can free itself.
+                full            = detached || items.size() >= capacity;
+            }
+            if (waitingConsumer) threadPool->submit(consumerThreadType, waitingConsumer);
+            return {*this, full};
+        }
+
+        void return_void() {
+        }
+
+        void unhandled_exception() {
+            std::lock_guard<std::mutex> lock(mutex);
+            exception = std::current_exception();
+        }
+    };
+
+    /** Awaited by the consumer for the next item. */
+    class Next {
+    public:
+        explicit Next(promise_type &t_promise) : m_promise(t_promise) {
+        }
+
+        bool await_ready() {
+            std::lock_guard<std::mutex> lock(m_promise.mutex);
+            return !m_promise.items.empty() || m_promise.done;
+        }
+
+        bool await_suspend(std::coroutine_handle<> t_handle) {
+            std::lock_guard<std::mutex> lock(m_promise.mutex);
+            if (!m_promise.items.empty() || m_promise.done) return false;
+            m_promise.consumer           = t_handle;
+            m_promise.consumerThreadType = m_promise.threadPool->thisThreadType();
+            return true;
+        }
+
+        std::optional<T> await_resume() {
+            std::optional<T> item;
+            bool             resumeProducer{false};
+            {
+                std::lock_guard<std::mutex> lock(m_promise.mutex);
+                if (m_promise.items.empty()) {
+                    if (m_promise.exception) std::rethrow_exception(std::exchange(m_promise.exception, nullptr));
+                    return item;
+                }
+                item.emplace(std::move(m_promise.items.front()));
+                m_promise.items.pop_front();
+                resumeProducer = !m_promise.running && !m_promise.done;
+                if (resumeProducer) m_promise.running = true;
+            }
+            if (resumeProducer) {
+                std::coroutine_handle<> producer = Handle::from_promise(m_promise);
+                m_promise.threadPool->submit(m_promise.threadType, producer);
+            }
+            return item;
+        }
+
+    private:
+        promise_type &m_promise;
+    };
+
+    AsyncGenerator(AsyncGenerator &&t_other) noexcept : m_handle(std::exchange(t_other.m_handle, nullptr)) {
+    }
+
+    AsyncGenerator &operator=(AsyncGenerator &&t_other) noexcept {
+        if (this != &t_other) {
+            release();
+            m_handle = std::exchange(t_other.m_handle, nullptr);
+        }
+        return *this;
+    }
+
+    AsyncGenerator(const AsyncGenerator &) = delete;
+
+    AsyncGenerator &operator=(const AsyncGenerator &) = delete;
+
+    ~AsyncGenerator() {
+        release();
+    }
+
+    /**
+     * @brief Start the producer on a thread of type t_threadType.
+     * @details The producer runs ahead of the consumer by up to t_capacity items. Only the first call has any
+     * effect.
+     */
+    void start(
+      ThreadPool *t_threadPool,
+      ThreadType  t_threadType = IE_THREAD_TYPE_WORKER_THREAD,
+      std::size_t t_capacity   = 1
+    ) {
+        promise_type &promise = m_handle.promise();
+        {
+            std::lock_guard<std::mutex> lock(promise.mutex);
+            if (promise.threadPool != nullptr) return;
+            promise.threadPool = t_threadPool;
+            promise.threadType = t_threadType;
+            promise.capacity   = std::max<std::size_t>(t_capacity, 1);
+            promise.running    = true;
+        }
+        t_threadPool->submit(t_threadType, std::coroutine_handle<>{m_handle});
+    }
+
+    /** @return An awaitable for the next item, which is empty once there are no more. Throws if not started. */
+    Next next() {
+        if (m_handle.promise().threadPool == nullptr)
+            throw std::runtime_error("attempt to await an item from a generator that has not been started!");
+        return Next{m_handle.promise()};
+    }
+
+private:
+    Handle m_handle;
+
+    explicit AsyncGenerator(Handle t_handle) : m_handle(t_handle) {
+    }
+
+    void release() {
+        if (!m_handle) return;
+        promise_type &promise = m_handle.promise();
+        bool          running;
+        {
+            std::lock_guard<std::mutex> lock(promise.mutex);
+            running          = promise.running;
+            promise.detached = running;
+        }
+        if (!running) m_handle.destroy();
+        m_handle = nullptr;
+    }
+};
+}  // namespace IE::Core::Threading
@@ -6,8 +6,14 @@
 void IE::Core::Threading::Awaitable::await_resume() {
 }
 
+bool IE::Core::Threading::Awaitable::resumableHere() const {
+    // Threads that belong to no pool, such as the reactor or IO threads, report that they are worker threads too.
+    if (m_threadType == IE_THREAD_TYPE_WORKER_THREAD) return Worker::currentThreadPool() == m_threadPool;
+    return m_threadPool->thisThreadType() == IE_THREAD_TYPE_MAIN_THREAD;
+}
+
 void IE::Core::Threading::Awaitable::submit(std::coroutine_handle<> t_handle) {
-    m_threadPool->submit(m_threadType, t_handle);
+    m_threadPool->submit(m_threadType, m_priority, t_handle);
 }
 
 IE::Core::Threading::Awaitable::Awaitable(
@@ -15,5 +21,6 @@ IE::Core::Threading::Awaitable::Awaitable(
   IE::Core::Threading::ThreadType  t_threadType
 ) :
         m_threadPool(t_threadPool),
-        m_threadType(t_threadType) {
+        m_threadType(t_threadType),
+        m_priority(Worker::currentPriority()) {
 }
@@ -5,6 +5,7 @@
 
 namespace std {
 using std::experimental::coroutine_handle;
+using std::experimental::noop_coroutine;
 using std::experimental::suspend_always;
 using std::experimental::suspend_never;
 }  // namespace std
@@ -17,6 +18,13 @@ enum ThreadType {
     IE_THREAD_TYPE_MAIN_THREAD,
     IE_THREAD_TYPE_WORKER_THREAD,
 };
+
+/// Workers take frame-critical work first, then normal work, then background work.
+enum TaskPriority {
+    IE_TASK_PRIORITY_FRAME_CRITICAL,
+    IE_TASK_PRIORITY_NORMAL,
+    IE_TASK_PRIORITY_BACKGROUND,
+};
 }  // namespace IE::Core::Threading
 
 namespace IE::Core::Threading {
@@ -27,18 +35,31 @@ public:
     // Indicates the readiness of the coroutine to continue. True -> resume, False -> suspend
     virtual bool await_ready() = 0;
 
-    virtual void await_suspend(std::coroutine_handle<> t_handle) = 0;
+    // Returns the coroutine to transfer to once t_handle has suspended. Returning t_handle resumes it right away.
+    virtual std::coroutine_handle<> await_suspend(std::coroutine_handle<> t_handle) = 0;
 
     virtual void await_resume();
 
-    virtual void releaseDependency() = 0;
+    /**
+     * @brief Called when one of the tasks that this awaitable is waiting on finishes.
+     * @return The suspended coroutine if that was the last one, or nullptr. The caller must then resume it.
+     */
+    virtual std::coroutine_handle<> releaseDependency() = 0;
+
+    /**
+     * @return True if a coroutine suspended on this awaitable may be resumed directly on the calling thread, which
+     * must then be one of the pool's workers or its main thread, as the awaitable's thread type asks for.
+     */
+    [[nodiscard]] bool resumableHere() const;
 
-protected:
     void submit(std::coroutine_handle<> t_handle);
 
+protected:
     Awaitable(ThreadPool *t_threadPool, ThreadType t_threadType);
 
-    ThreadPool *m_threadPool;
-    ThreadType  m_threadType;
+    ThreadPool  *m_threadPool;
+    ThreadType   m_threadType;
+    // The priority of the task that created this awaitable. The awaiting coroutine is resumed at this priority.
+    TaskPriority m_priority;
 };
 }  // namespace IE::Core::Threading
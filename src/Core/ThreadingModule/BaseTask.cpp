@@ -1,5 +1,65 @@
 #include "BaseTask.hpp"
 
+#include "Awaitable.hpp"
+#include "Statistics.hpp"
+#include "Tracer.hpp"
+
+IE::Core::Threading::BaseTask::BaseTask(const IE::Core::Threading::BaseTask &) {
+}
+
+thread_local IE::Core::Threading::BaseTask *IE::Core::Threading::BaseTask::m_current{nullptr};
+thread_local uint32_t                      IE::Core::Threading::BaseTask::m_inlineContinuations{0};
+
 bool IE::Core::Threading::BaseTask::finished() const {
-    return *m_finished;
-}
\ No newline at end of file
+    return m_finished;
+}
+
+bool IE::Core::Threading::BaseTask::cancelled() const {
+    return m_cancelled;
+}
+
+IE::Core::Threading::BaseTask *IE::Core::Threading::BaseTask::current() {
+    return m_current;
+}
+
+bool IE::Core::Threading::BaseTask::addDependent(IE::Core::Threading::Awaitable *t_dependent) {
+    std::lock_guard<std::mutex> lock{m_dependentsMutex};
+    if (m_dependentsReleased) return false;
+    m_dependents.push_back(t_dependent);
+    return true;
+}
+
+std::coroutine_handle<> IE::Core::Threading::BaseTask::finish() {
+    ThreadStatistics::taskFinished(*this);
+    std::vector<Awaitable *> dependents;
+    {
+        std::lock_guard<std::mutex> lock{m_dependentsMutex};
+        m_dependentsReleased = true;
+        dependents.swap(m_dependents);
+    }
+    std::coroutine_handle<> continuation{nullptr};
+    for (Awaitable *dependent : dependents) {
+        std::coroutine_handle<> handle = dependent->releaseDependency();
+        if (!handle) continue;
+        Tracer::flowStart(handle.address());
+        // Continuing inline skips a trip through the queues, but a long chain of them would never give the thread
+        // back to the pool, so every so often one goes through the queues anyway.
+        if (!continuation && dependent->resumableHere()) {
+            if (m_inlineContinuations < MAX_INLINE_CONTINUATIONS) {
+                ++m_inlineContinuations;
+                continuation = handle;
+                continue;
+            }
+            m_inlineContinuations = 0;
+        }
+        dependent->submit(handle);
+    }
+    // Publishes the task's result to anything that sees it as finished.
+    m_finished.store(true, std::memory_order_release);
+    m_finished.notify_all();
+    if (std::atomic<uint32_t> *epoch = m_finishedEpoch.load(); epoch != nullptr) {
+        epoch->fetch_add(1);
+        epoch->notify_all();
+    }
+    return continuation;
+}
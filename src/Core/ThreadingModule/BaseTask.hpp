@@ -1,24 +1,85 @@
 #pragma once
 
+#include "Awaitable.hpp"
+#include "CancellationToken.hpp"
+
 #include <atomic>
-#include <condition_variable>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 namespace IE::Core::Threading {
-class Awaitable;
-
+/**
+ * @brief The type-erased part of a Task.
+ * @details All of the synchronization state that a task needs lives directly in the task object. Tasks are
+ * allocated together with their shared_ptr control block from the per-thread task pool, so no additional
+ * allocations are needed to submit one.
+ */
 class BaseTask {
 public:
+    BaseTask() = default;
+
+    // The synchronization state belongs to one particular task object, so copies start out fresh.
+    BaseTask(const BaseTask &t_other);
+
     virtual ~BaseTask() = default;
 
     [[nodiscard]] bool finished() const;
 
+    /** @return True if the task was cancelled rather than running to completion. Only valid once finished. */
+    [[nodiscard]] bool cancelled() const;
+
+    /** @return The task that the calling thread is executing, or nullptr if it is not executing one. */
+    static BaseTask *current();
+
+    /// How many coroutines a thread may continue directly, one after another, before going back through the pool.
+    static constexpr uint32_t MAX_INLINE_CONTINUATIONS{64};
+
     virtual void execute() = 0;
 
-    std::shared_ptr<std::atomic<bool>>           m_finished{std::make_shared<std::atomic<bool>>()};
-    std::shared_ptr<std::condition_variable_any> m_finishedNotifier{
-      std::make_shared<std::condition_variable_any>()};
-    std::shared_ptr<std::mutex> m_dependentsMutex{std::make_shared<std::mutex>()};
-    std::vector<Awaitable *>    m_dependents{};
+    /**
+     * @brief Free a task that will never be executed, such as one still queued when its pool is destroyed.
+     * @details The task is marked as cancelled and finished. Its dependents are not released.
+     */
+    virtual void abandon() = 0;
+
+    /**
+     * @brief Have t_dependent's releaseDependency() called when this task finishes.
+     * @return False if the task has already finished, in which case t_dependent is not registered.
+     */
+    bool addDependent(Awaitable *t_dependent);
+
+    /**
+     * @brief Release all dependents, then mark the task as finished and wake anything waiting on it.
+     * @details At most one dependent that may run on this thread is not submitted to the thread pool, but returned
+     * so that the caller can continue it directly.
+     * @return The coroutine to continue, or nullptr.
+     */
+    std::coroutine_handle<> finish();
+
+    // Waiters block on this directly with std::atomic::wait rather than through a separate notifier.
+    std::atomic<bool>                    m_finished{false};
+    // An event count to bump when the task finishes, for waiters that also need to be woken by other work.
+    std::atomic<std::atomic<uint32_t> *> m_finishedEpoch{nullptr};
+    std::mutex                           m_dependentsMutex{};
+    std::vector<Awaitable *>             m_dependents{};
+    // Set under m_dependentsMutex once the dependents have been released, so that no more can be added.
+    bool                                 m_dependentsReleased{false};
+    TaskPriority                         m_priority{IE_TASK_PRIORITY_NORMAL};
+    CancellationToken                    m_cancellationToken{};
+    bool                                 m_cancelled{false};
+    // Set while the task sits in a worker's deque, which can only hold raw pointers.
+    std::shared_ptr<BaseTask>            m_self{};
+#if defined(IE_THREADING_STATISTICS)
+    std::chrono::steady_clock::time_point m_submitTime{};
+    std::chrono::steady_clock::time_point m_startTime{};
+#endif
+
+    // Set by workers when they execute a task, and by coroutines whenever they resume.
+    static thread_local BaseTask *m_current;
+    // The number of coroutines that this thread has continued directly since it last went back to the pool.
+    static thread_local uint32_t  m_inlineContinuations;
 };
 }  // namespace IE::Core::Threading
\ No newline at end of file
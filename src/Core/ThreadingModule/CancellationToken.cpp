@@ -0,0 +1,19 @@
+#include "CancellationToken.hpp"
+
+IE::Core::Threading::CancellationToken IE::Core::Threading::CancellationToken::create() {
+    CancellationToken token;
+    token.m_cancelled = std::make_shared<std::atomic<bool>>(false);
+    return token;
+}
+
+void IE::Core::Threading::CancellationToken::cancel() {
+    if (m_cancelled) m_cancelled->store(true, std::memory_order_release);
+}
+
+bool IE::Core::Threading::CancellationToken::cancelled() const {
+    return m_cancelled && m_cancelled->load(std::memory_order_acquire);
+}
+
+const char *IE::Core::Threading::TaskCancelled::what() const noexcept {
+    return "task cancelled";
+}
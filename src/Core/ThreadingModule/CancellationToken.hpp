@@ -0,0 +1,39 @@
+#pragma once
+
+#include <atomic>
+#include <exception>
+#include <memory>
+
+namespace IE::Core::Threading {
+/**
+ * @brief A shared flag used to ask tasks to stop.
+ * @details Copies of a token share the same flag. Tasks submitted with a token check it before they start and
+ * every time they resume from a co_await. Once it is set, a task that has not started is destroyed without
+ * running, and a running task stops at its next co_await. Either way it finishes as cancelled, releasing
+ * everything waiting on it. Tasks submitted without a token inherit the token of the task that submits them.
+ */
+class CancellationToken {
+public:
+    /** Construct a token that can never be cancelled. It does not allocate. */
+    CancellationToken() = default;
+
+    /** @return A new token that can be cancelled. */
+    static CancellationToken create();
+
+    void cancel();
+
+    [[nodiscard]] bool cancelled() const;
+
+private:
+    std::shared_ptr<std::atomic<bool>> m_cancelled;
+};
+
+/**
+ * Thrown out of a co_await in a task whose token has been cancelled, and caught by the task itself. Also thrown by
+ * Future::get() and SharedFuture::get() for a task that was cancelled.
+ */
+class TaskCancelled : public std::exception {
+public:
+    [[nodiscard]] const char *what() const noexcept override;
+};
+}  // namespace IE::Core::Threading
@@ -0,0 +1 @@
+#include "Deque.hpp"
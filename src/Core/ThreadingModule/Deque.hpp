@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace IE::Core::Threading {
+/**
+ * @brief A Chase-Lev work-stealing deque.
+ * @details Exactly one thread (the owner) may call push() and pop(), which operate on the bottom of the deque in
+ * LIFO order. Any number of other threads may concurrently call steal(), which takes from the top in FIFO order.
+ * The backing array grows as needed. Retired arrays are kept alive until the deque is destroyed because a thief
+ * may still be reading from them.
+ * @tparam T The type of the elements. Must be trivially copyable, as elements are read racily by thieves.
+ */
+template<typename T>
+class Deque {
+    static_assert(std::is_trivially_copyable_v<T>, "Deque elements must be trivially copyable.");
+
+    static constexpr std::size_t CACHE_LINE_SIZE{64};
+
+    struct Array {
+        std::size_t                       capacity;
+        std::unique_ptr<std::atomic<T>[]> data{std::make_unique<std::atomic<T>[]>(capacity)};
+
+        explicit Array(std::size_t t_capacity) : capacity(t_capacity) {
+        }
+
+        T get(int64_t t_index) const {
+            return data[t_index & (capacity - 1)].load(std::memory_order_relaxed);
+        }
+
+        void put(int64_t t_index, T t_value) {
+            data[t_index & (capacity - 1)].store(t_value, std::memory_order_relaxed);
+        }
+    };
+
+    alignas(CACHE_LINE_SIZE) std::atomic<int64_t> m_top{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<int64_t> m_bottom{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<Array *> m_array;
+    std::vector<std::unique_ptr<Array>> m_arrays;  // Only touched by the owner.
+
+    Array *grow(Array *t_array, int64_t t_bottom, int64_t t_top) {
+        auto *array = m_arrays.emplace_back(std::make_unique<Array>(t_array->capacity * 2)).get();
+        for (int64_t i{t_top}; i < t_bottom; ++i) array->put(i, t_array->get(i));
+        m_array.store(array, std::memory_order_release);
+        return array;
+    }
+
+public:
+    /** @param t_capacity The initial capacity of the deque. Must be a power of two. */
+    explicit Deque(std::size_t t_capacity = 64) {
+        m_array.store(m_arrays.emplace_back(std::make_unique<Array>(t_capacity)).get(), std::memory_order_relaxed);
+    }
+
+    Deque(const Deque &) = delete;
+
+    Deque &operator=(const Deque &) = delete;
+
+    /** Push to the bottom of the deque. May only be called by the owner. */
+    void push(T t_value) {
+        int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+        int64_t top    = m_top.load(std::memory_order_acquire);
+        Array  *array  = m_array.load(std::memory_order_relaxed);
+        if (bottom - top > (int64_t) array->capacity - 1) array = grow(array, bottom, top);
+        array->put(bottom, t_value);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    /** Pop from the bottom of the deque. May only be called by the owner. */
+    bool pop(T &t_value) {
+        int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        Array  *array  = m_array.load(std::memory_order_relaxed);
+        m_bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = m_top.load(std::memory_order_relaxed);
+        if (top > bottom) {
+            // The deque was already empty.
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return false;
+        }
+        t_value = array->get(bottom);
+        if (top == bottom) {
+            // This is the last element, so race any thieves for it.
+            bool won =
+              m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    /** Steal from the top of the deque. May be called by any thread. */
+    bool steal(T &t_value) {
+        int64_t top = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t bottom = m_bottom.load(std::memory_order_acquire);
+        if (top >= bottom) return false;
+        t_value = m_array.load(std::memory_order_acquire)->get(top);
+        return m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    /** @return The approximate number of elements in the deque. */
+    std::size_t size() const {
+        int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+        int64_t top    = m_top.load(std::memory_order_relaxed);
+        return bottom > top ? bottom - top : 0;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+};
+}  // namespace IE::Core::Threading
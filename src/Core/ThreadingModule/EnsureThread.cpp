@@ -2,8 +2,6 @@
 
 #include "ThreadPool.hpp"
 
-#include <thread>
-
 IE::Core::Threading::EnsureThread::EnsureThread(
   IE::Core::Threading::ThreadPool *t_threadPool,
   IE::Core::Threading::ThreadType  t_threadType
@@ -12,12 +10,14 @@ IE::Core::Threading::EnsureThread::EnsureThread(
 }
 
 bool IE::Core::Threading::EnsureThread::await_ready() {
-    return std::this_thread::get_id() == m_threadPool->mainThreadID ^ (m_type != IE_THREAD_TYPE_MAIN_THREAD);
+    return m_threadPool->thisThreadType() == m_threadType;
 }
 
-void IE::Core::Threading::EnsureThread::await_suspend(std::coroutine_handle<> t_handle) {
-    m_threadPool->submit(m_type, t_handle);
+std::coroutine_handle<> IE::Core::Threading::EnsureThread::await_suspend(std::coroutine_handle<> t_handle) {
+    m_threadPool->submit(m_threadType, m_priority, t_handle);
+    return std::noop_coroutine();
 }
 
-void IE::Core::Threading::EnsureThread::releaseDependency() {
+std::coroutine_handle<> IE::Core::Threading::EnsureThread::releaseDependency() {
+    return nullptr;
 }
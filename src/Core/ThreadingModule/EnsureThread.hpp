@@ -11,13 +11,10 @@ public:
 
     bool await_ready() override;
 
-    void releaseDependency() override;
+    std::coroutine_handle<> releaseDependency() override;
 
-    void await_suspend(std::coroutine_handle<> t_handle) override;
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> t_handle) override;
 
     virtual ~EnsureThread() = default;
-
-protected:
-    ThreadType m_type;
 };
 }  // namespace IE::Core::Threading
\ No newline at end of file
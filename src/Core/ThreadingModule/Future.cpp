@@ -0,0 +1 @@
+#include "Future.hpp"
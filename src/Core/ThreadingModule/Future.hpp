@@ -0,0 +1,142 @@
+#pragma once
+
+#include "ThreadPool.hpp"
+
+#include <memory>
+#include <type_traits>
+
+namespace IE::Core::Threading {
+template<typename T>
+class Future;
+
+template<typename T>
+class SharedFuture;
+
+namespace detail {
+template<typename T, typename F>
+struct ThenResult {
+    using type = std::invoke_result_t<F, const T &>;
+};
+
+template<typename F>
+struct ThenResult<void, F> {
+    using type = std::invoke_result_t<F>;
+};
+
+template<typename T, typename F>
+Task<typename ThenResult<T, F>::type>
+then(ThreadPool *t_threadPool, ThreadType t_threadType, std::shared_ptr<Task<T>> t_task, F t_function) {
+    co_await t_threadPool->resumeAfter(t_threadType, t_task);
+    // A cancelled task never set its value, so cancel the continuation too rather than hand it one.
+    if (t_task->cancelled()) throw TaskCancelled{};
+    if constexpr (std::is_void_v<T>) co_return t_function();
+    else co_return t_function(t_task->valueReference());
+}
+
+/** The part of Future and SharedFuture that does not depend on who may read the result. */
+template<typename T>
+class FutureBase {
+public:
+    FutureBase() = default;
+
+    FutureBase(ThreadPool *t_threadPool, std::shared_ptr<Task<T>> t_task) :
+            m_threadPool(t_threadPool),
+            m_task(std::move(t_task)) {
+    }
+
+    [[nodiscard]] bool valid() const {
+        return m_task != nullptr;
+    }
+
+    /** @return True once the result can be read. Never blocks. */
+    [[nodiscard]] bool ready() const {
+        // Pairs with the release in BaseTask::finish(), which publishes the result.
+        return m_task->m_finished.load(std::memory_order_acquire);
+    }
+
+    /** Block until the result can be read, helping to execute other tasks in the meantime. */
+    void wait() const {
+        if (!ready()) Worker::waitForTask(m_threadPool, *m_task);
+    }
+
+    /**
+     * @brief Call t_function with the result once it is ready, on a thread of type t_threadType.
+     * @details If the task is cancelled, t_function is not called and the returned future is cancelled as well.
+     * @return A future for the result of t_function.
+     */
+    template<typename F>
+    auto then(ThreadType t_threadType, F t_function) const {
+        using Result = typename ThenResult<T, F>::type;
+        Task<Result> continuation{detail::then(m_threadPool, t_threadType, m_task, std::move(t_function))};
+        return Future<Result>{m_threadPool, m_threadPool->submit(t_threadType, continuation)};
+    }
+
+    template<typename F>
+    auto then(F t_function) const {
+        return then(IE_THREAD_TYPE_WORKER_THREAD, std::move(t_function));
+    }
+
+    [[nodiscard]] const std::shared_ptr<Task<T>> &task() const {
+        return m_task;
+    }
+
+protected:
+    ThreadPool              *m_threadPool{};
+    std::shared_ptr<Task<T>> m_task;
+};
+}  // namespace detail
+
+/**
+ * @brief The result of a task, for a single reader.
+ * @details Checking whether the result is ready takes a single acquire load of the task's finished flag, so
+ * reading a finished result never takes a lock. Coroutines should not block on get(), but wait for the task with
+ * resumeAfter(task()), or chain work after it with then().
+ */
+template<typename T>
+class Future : public detail::FutureBase<T> {
+public:
+    using detail::FutureBase<T>::FutureBase;
+
+    Future(const Future &) = delete;
+
+    Future &operator=(const Future &) = delete;
+
+    Future(Future &&) noexcept = default;
+
+    Future &operator=(Future &&) noexcept = default;
+
+    /** Wait for the result, then return it. Throws TaskCancelled if the task was cancelled. */
+    T get() {
+        this->wait();
+        if (this->m_task->cancelled()) throw TaskCancelled{};
+        if constexpr (!std::is_void_v<T>) return this->m_task->value();
+    }
+
+    /** Give up this future in exchange for one that any number of readers may share. */
+    SharedFuture<T> share() {
+        return SharedFuture<T>{this->m_threadPool, std::move(this->m_task)};
+    }
+};
+
+/**
+ * @brief The result of a task, for any number of readers.
+ * @details Copies refer to the same result, which every reader gets by reference without copying it. As with
+ * Future, a finished result can be read without taking a lock, so many readers of one loaded asset can share it
+ * cheaply.
+ */
+template<typename T>
+class SharedFuture : public detail::FutureBase<T> {
+public:
+    using detail::FutureBase<T>::FutureBase;
+
+    /**
+     * @brief Wait for the result, then return it. Throws TaskCancelled if the task was cancelled.
+     * @return A reference that stays valid for as long as any copy of this future.
+     */
+    std::conditional_t<std::is_void_v<T>, void, const T &> get() const {
+        this->wait();
+        if (this->m_task->cancelled()) throw TaskCancelled{};
+        if constexpr (!std::is_void_v<T>) return this->m_task->valueReference();
+    }
+};
+}  // namespace IE::Core::Threading
@@ -1,35 +1,154 @@
 #pragma once
 
-#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iterator>
 #include <memory>
 #include <mutex>
-#include <queue>
 
 namespace IE::Core::Threading {
-/** A thread-safe FIFO queue for use in the thread pool. */
-/**@todo Develop a lock-free variant of this. */
-template<typename T>
+/**
+ * @brief A thread-safe FIFO queue for use in the thread pool.
+ * @details The fast path is a bounded, lock-free multi-producer/multi-consumer ring buffer. Every cell carries a
+ * sequence number that tells producers and consumers whether the cell is ready for them, so neither side takes a
+ * lock or moves any other element. Should the ring ever fill up, elements spill into a mutex guarded overflow list
+ * so that push() never blocks or fails. While the overflow list is non-empty all pushes go to it, keeping the
+ * ordering approximately FIFO.
+ * @tparam T The type of the elements in the queue.
+ * @tparam Capacity The number of elements that the lock-free ring can hold. Must be a power of two.
+ */
+template<typename T, std::size_t Capacity = 4096>
 class Queue {
-    std::vector<T> m_queue;
-    std::mutex     m_mutex;
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Queue capacity must be a power of two.");
+
+    static constexpr std::size_t CACHE_LINE_SIZE{64};
+    static constexpr std::size_t MASK{Capacity - 1};
+
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        T                        value;
+    };
+
+    std::unique_ptr<Cell[]> m_cells{std::make_unique<Cell[]>(Capacity)};
+    // Producers and consumers each get their own cache line to avoid false sharing between the two ends.
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> m_enqueuePosition{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> m_dequeuePosition{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> m_overflowSize{0};
+    std::mutex    m_overflowMutex;
+    std::deque<T> m_overflow;
+
+    bool tryPush(T &t_value) {
+        Cell       *cell;
+        std::size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+        while (true) {
+            cell                     = &m_cells[position & MASK];
+            std::size_t   sequence   = cell->sequence.load(std::memory_order_acquire);
+            std::intptr_t difference = (std::intptr_t) sequence - (std::intptr_t) position;
+            if (difference == 0) {
+                if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            } else if (difference < 0) return false;  // The ring is full.
+            else position = m_enqueuePosition.load(std::memory_order_relaxed);
+        }
+        cell->value = std::move(t_value);
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Claim t_count consecutive cells with a single CAS, and fill them from t_first. */
+    template<typename Iterator>
+    bool tryPush(Iterator t_first, std::size_t t_count) {
+        std::size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+        while (true) {
+            // Consumers may free cells out of order, so every cell in the batch has to be checked.
+            std::intptr_t difference{0};
+            for (std::size_t i{0}; i < t_count && difference == 0; ++i) {
+                std::size_t sequence = m_cells[(position + i) & MASK].sequence.load(std::memory_order_acquire);
+                difference           = (std::intptr_t) sequence - (std::intptr_t) (position + i);
+            }
+            if (difference == 0) {
+                std::size_t end = position + t_count;
+                if (m_enqueuePosition.compare_exchange_weak(position, end, std::memory_order_relaxed)) break;
+            } else if (difference < 0) return false;  // The ring does not have room for the whole batch.
+            else position = m_enqueuePosition.load(std::memory_order_relaxed);
+        }
+        for (std::size_t i{0}; i < t_count; ++i, ++t_first) {
+            Cell &cell = m_cells[(position + i) & MASK];
+            cell.value = std::move(*t_first);
+            cell.sequence.store(position + i + 1, std::memory_order_release);
+        }
+        return true;
+    }
+
+    bool tryPop(T &t_value) {
+        Cell       *cell;
+        std::size_t position = m_dequeuePosition.load(std::memory_order_relaxed);
+        while (true) {
+            cell                     = &m_cells[position & MASK];
+            std::size_t   sequence   = cell->sequence.load(std::memory_order_acquire);
+            std::intptr_t difference = (std::intptr_t) sequence - (std::intptr_t) (position + 1);
+            if (difference == 0) {
+                if (m_dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            } else if (difference < 0) return false;  // The ring is empty.
+            else position = m_dequeuePosition.load(std::memory_order_relaxed);
+        }
+        t_value = std::move(cell->value);
+        cell->sequence.store(position + Capacity, std::memory_order_release);
+        return true;
+    }
 
 public:
+    Queue() {
+        for (std::size_t i{0}; i < Capacity; ++i) m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    Queue(const Queue &) = delete;
+
+    Queue &operator=(const Queue &) = delete;
+
     void push(T t_value) {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        m_queue.push_back(t_value);
+        if (m_overflowSize.load(std::memory_order_acquire) == 0 && tryPush(t_value)) return;
+        std::lock_guard<std::mutex> lock(m_overflowMutex);
+        m_overflow.push_back(std::move(t_value));
+        m_overflowSize.fetch_add(1, std::memory_order_release);
+    }
+
+    /** Push every element of [t_first, t_last), moving them out of the range. Only one CAS or lock is taken. */
+    template<typename Iterator>
+    void push(Iterator t_first, Iterator t_last) {
+        auto count = static_cast<std::size_t>(std::distance(t_first, t_last));
+        if (count == 0) return;
+        if (count <= Capacity && m_overflowSize.load(std::memory_order_acquire) == 0 && tryPush(t_first, count))
+            return;
+        std::lock_guard<std::mutex> lock(m_overflowMutex);
+        m_overflow.insert(m_overflow.end(), std::make_move_iterator(t_first), std::make_move_iterator(t_last));
+        m_overflowSize.fetch_add(count, std::memory_order_release);
     }
 
     bool pop(T &t_value) {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        if (m_queue.empty()) return false;
-        t_value = *m_queue.begin();
-        m_queue.erase(m_queue.begin());
+        if (tryPop(t_value)) return true;
+        if (m_overflowSize.load(std::memory_order_acquire) == 0) return false;
+        std::lock_guard<std::mutex> lock(m_overflowMutex);
+        if (m_overflow.empty()) return false;
+        t_value = std::move(m_overflow.front());
+        m_overflow.pop_front();
+        m_overflowSize.fetch_sub(1, std::memory_order_release);
         return true;
     }
 
+    /** @return The approximate number of elements in the queue. Only exact when no other thread is using it. */
+    std::size_t size() {
+        std::size_t dequeuePosition = m_dequeuePosition.load(std::memory_order_acquire);
+        std::size_t enqueuePosition = m_enqueuePosition.load(std::memory_order_acquire);
+        std::size_t ringSize        = enqueuePosition > dequeuePosition ? enqueuePosition - dequeuePosition : 0;
+        return ringSize + m_overflowSize.load(std::memory_order_acquire);
+    }
+
     bool empty() {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        return m_queue.empty();
+        return size() == 0;
     }
 };
-}  // namespace IE::Core::Threading
\ No newline at end of file
+}  // namespace IE::Core::Threading
@@ -0,0 +1,121 @@
+#include "Reactor.hpp"
+
+#include "ThreadPool.hpp"
+#include "Topology.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#if defined(__linux__)
+#    include <sys/epoll.h>
+#    include <sys/eventfd.h>
+#    include <unistd.h>
+#endif
+
+IE::Core::Threading::Reactor::Reactor(IE::Core::Threading::ThreadPool *t_threadPool) : m_threadPool(t_threadPool) {
+#if defined(__linux__)
+    m_epoll  = epoll_create1(EPOLL_CLOEXEC);
+    m_wakeup = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    epoll_event event{.events = EPOLLIN, .data = {.fd = m_wakeup}};
+    epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wakeup, &event);
+#endif
+    m_thread = std::thread([this] { run(); });
+}
+
+IE::Core::Threading::Reactor::~Reactor() {
+    m_shutdown = true;
+    wake();
+    if (m_thread.joinable()) m_thread.join();
+#if defined(__linux__)
+    close(m_wakeup);
+    close(m_epoll);
+#endif
+}
+
+void IE::Core::Threading::Reactor::addTimer(Clock::time_point t_deadline, Waiter t_waiter) {
+    bool earliest;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        earliest = m_timers.empty() || t_deadline < m_timers.top().deadline;
+        m_timers.push({t_deadline, t_waiter});
+    }
+    // The reactor only needs to hear about timers that expire before the one that it is already waiting for.
+    if (earliest) wake();
+}
+
+bool IE::Core::Threading::Reactor::addReadable(int t_fileDescriptor, Waiter t_waiter) {
+#if defined(__linux__)
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // A file descriptor stays registered until it becomes readable, which resumes everything waiting on it.
+    if (auto waiters = m_readableWaiters.find(t_fileDescriptor); waiters != m_readableWaiters.end()) {
+        waiters->second.push_back(t_waiter);
+        return true;
+    }
+    epoll_event event{.events = EPOLLIN | EPOLLONESHOT, .data = {.fd = t_fileDescriptor}};
+    if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, t_fileDescriptor, &event) != 0) return false;
+    m_readableWaiters[t_fileDescriptor].push_back(t_waiter);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void IE::Core::Threading::Reactor::run() {
+    Topology::nameThisThread("IE Reactor");
+    std::vector<Waiter> ready;
+    while (!m_shutdown) {
+        // Sleep until the next timer is due, or until something else happens.
+        std::unique_lock<std::mutex> lock(m_mutex);
+#if defined(__linux__)
+        int timeout{-1};
+        if (!m_timers.empty()) {
+            auto    remaining    = m_timers.top().deadline - Clock::now();
+            // Round up so that the reactor does not wake up just before the deadline and spin.
+            int64_t milliseconds = std::chrono::ceil<std::chrono::milliseconds>(remaining).count();
+            timeout              =
+              static_cast<int>(std::clamp<int64_t>(milliseconds, 0, std::numeric_limits<int>::max()));
+        }
+        lock.unlock();
+        epoll_event events[64];
+        int         eventCount = epoll_wait(m_epoll, events, 64, timeout);
+        lock.lock();
+        for (int i{0}; i < eventCount; ++i) {
+            if (events[i].data.fd == m_wakeup) {
+                uint64_t value;
+                while (read(m_wakeup, &value, sizeof(value)) > 0) {}
+                continue;
+            }
+            auto waiters = m_readableWaiters.find(events[i].data.fd);
+            if (waiters == m_readableWaiters.end()) continue;
+            epoll_ctl(m_epoll, EPOLL_CTL_DEL, waiters->first, nullptr);
+            ready.insert(ready.end(), waiters->second.begin(), waiters->second.end());
+            m_readableWaiters.erase(waiters);
+        }
+#else
+        if (m_shutdown) break;
+        if (m_timers.empty()) m_condition.wait(lock);
+        else m_condition.wait_until(lock, m_timers.top().deadline);
+#endif
+        for (Clock::time_point now = Clock::now(); !m_timers.empty() && m_timers.top().deadline <= now;) {
+            ready.push_back(m_timers.top().waiter);
+            m_timers.pop();
+        }
+        lock.unlock();
+        for (const Waiter &waiter : ready) resume(waiter);
+        ready.clear();
+    }
+}
+
+void IE::Core::Threading::Reactor::wake() {
+#if defined(__linux__)
+    uint64_t value{1};
+    (void) write(m_wakeup, &value, sizeof(value));
+#else
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_condition.notify_one();
+#endif
+}
+
+void IE::Core::Threading::Reactor::resume(const Waiter &t_waiter) {
+    m_threadPool->submit(t_waiter.threadType, t_waiter.priority, t_waiter.handle);
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Awaitable.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace IE::Core::Threading {
+class ThreadPool;
+
+/**
+ * @brief A thread that waits on timers and file descriptors for coroutines that have suspended on them.
+ * @details Suspended coroutines are only recorded here. When a timer expires or a file descriptor becomes ready,
+ * the coroutine is submitted back to the thread pool, so no worker is held while it waits. Timers are kept in a
+ * min-heap. File descriptors are watched with epoll, which is also what the reactor sleeps on. On platforms
+ * without epoll the reactor only handles timers.
+ */
+class Reactor {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /** Everything needed to resume a suspended coroutine. */
+    struct Waiter {
+        std::coroutine_handle<> handle;
+        ThreadType              threadType;
+        TaskPriority            priority;
+    };
+
+    explicit Reactor(ThreadPool *t_threadPool);
+
+    Reactor(const Reactor &) = delete;
+
+    Reactor &operator=(const Reactor &) = delete;
+
+    /**
+     * @brief Stop the reactor thread. Coroutines that are still waiting are never resumed.
+     * @details The reactor only keeps their handles, so it never destroys their frames. Whoever owns those
+     * coroutines stays responsible for them.
+     */
+    ~Reactor();
+
+    void addTimer(Clock::time_point t_deadline, Waiter t_waiter);
+
+    /**
+     * @brief Resume t_waiter once t_fileDescriptor can be read from without blocking.
+     * @details Any number of coroutines may wait on the same file descriptor. They are all resumed together once
+     * it becomes readable.
+     * @return False if the file descriptor can not be watched, in which case the caller must resume t_waiter.
+     */
+    bool addReadable(int t_fileDescriptor, Waiter t_waiter);
+
+private:
+    struct Timer {
+        Clock::time_point deadline;
+        Waiter            waiter;
+
+        bool operator>(const Timer &t_other) const {
+            return deadline > t_other.deadline;
+        }
+    };
+
+    using TimerHeap = std::priority_queue<Timer, std::vector<Timer>, std::greater<>>;
+
+    ThreadPool             *m_threadPool;
+    std::mutex              m_mutex;
+    TimerHeap               m_timers;
+    std::atomic<bool>       m_shutdown{false};
+#if defined(__linux__)
+    int                                          m_epoll;
+    int                                          m_wakeup;  // An eventfd.
+    // The coroutines waiting on each file descriptor that is registered with epoll.
+    std::unordered_map<int, std::vector<Waiter>> m_readableWaiters;
+#else
+    std::condition_variable m_condition;
+#endif
+    std::thread             m_thread;
+
+    void run();
+
+    /** Interrupt the reactor thread's wait so that it picks up a new deadline. */
+    void wake();
+
+    void resume(const Waiter &t_waiter);
+};
+}  // namespace IE::Core::Threading
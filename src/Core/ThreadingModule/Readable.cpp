@@ -0,0 +1,27 @@
+#include "Readable.hpp"
+
+#include "ThreadPool.hpp"
+
+IE::Core::Threading::Readable::Readable(
+  IE::Core::Threading::ThreadPool *t_threadPool,
+  IE::Core::Threading::ThreadType  t_threadType,
+  int                              t_fileDescriptor
+) :
+        Awaitable(t_threadPool, t_threadType),
+        m_fileDescriptor(t_fileDescriptor) {
+}
+
+bool IE::Core::Threading::Readable::await_ready() {
+    return false;
+}
+
+std::coroutine_handle<> IE::Core::Threading::Readable::await_suspend(std::coroutine_handle<> t_handle) {
+    // If the file descriptor can not be watched, let the coroutine carry on and find out for itself.
+    if (!m_threadPool->getReactor().addReadable(m_fileDescriptor, {t_handle, m_threadType, m_priority}))
+        return t_handle;
+    return std::noop_coroutine();
+}
+
+std::coroutine_handle<> IE::Core::Threading::Readable::releaseDependency() {
+    return nullptr;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Awaitable.hpp"
+
+namespace IE::Core::Threading {
+class ThreadPool;
+
+/**
+ * @brief Suspends the awaiting coroutine until a file descriptor can be read from, without holding a worker.
+ * @details Several coroutines may wait on the same file descriptor, and are all resumed once it can be read from.
+ * File descriptors that can not be watched, such as regular files, and all file descriptors on platforms without
+ * epoll, are treated as readable.
+ */
+class Readable : public Awaitable {
+public:
+    Readable(ThreadPool *t_threadPool, ThreadType t_threadType, int t_fileDescriptor);
+
+    bool await_ready() override;
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> t_handle) override;
+
+    std::coroutine_handle<> releaseDependency() override;
+
+    virtual ~Readable() = default;
+
+protected:
+    int m_fileDescriptor;
+};
+}  // namespace IE::Core::Threading
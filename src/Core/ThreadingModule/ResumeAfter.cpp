@@ -3,20 +3,22 @@
 #include "ThreadPool.hpp"
 
 bool IE::Core::Threading::ResumeAfter::await_ready() {
-    return *m_dependencyCount == 0;
+    return m_dependencyCount.load(std::memory_order_acquire) == 1;
 }
 
-#if defined(AppleClang)
-void IE::Core::Threading::ResumeAfter::await_suspend(std::experimental::coroutine_handle<> t_handle) {
-#else
-void IE::Core::Threading::ResumeAfter::await_suspend(std::coroutine_handle<> t_handle) {
-#endif
-    m_handle->store(t_handle);
+std::coroutine_handle<> IE::Core::Threading::ResumeAfter::await_suspend(std::coroutine_handle<> t_handle) {
+    m_handle = t_handle;
+    // If every dependency finished while the coroutine was suspending, nobody else will resume it.
+    if (m_dependencyCount.fetch_sub(1, std::memory_order_acq_rel) == 1) return t_handle;
+    return std::noop_coroutine();
 }
 
-void IE::Core::Threading::ResumeAfter::releaseDependency() {
-    if (--*m_dependencyCount == 0) {
-        submit(m_handle->load());
-        m_threadPool->awakenAll();
-    }
+std::coroutine_handle<> IE::Core::Threading::ResumeAfter::releaseDependency() {
+    if (m_dependencyCount.fetch_sub(1, std::memory_order_acq_rel) == 1) return m_handle;
+    return nullptr;
+}
+
+void IE::Core::Threading::ResumeAfter::addDependency(const std::shared_ptr<BaseTask> &t_task) {
+    m_dependencyCount.fetch_add(1, std::memory_order_relaxed);
+    if (!t_task->addDependent(this)) m_dependencyCount.fetch_sub(1, std::memory_order_relaxed);
 }
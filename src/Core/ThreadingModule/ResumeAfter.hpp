@@ -11,6 +11,7 @@
 
 namespace std {
 using std::experimental::coroutine_handle;
+using std::experimental::noop_coroutine;
 using std::experimental::suspend_always;
 using std::experimental::suspend_never;
 }  // namespace std
@@ -21,21 +22,18 @@ using std::experimental::suspend_never;
 namespace IE::Core::Threading {
 class ThreadPool;
 
+/**
+ * @brief Suspends the awaiting coroutine until all of the given tasks have finished.
+ * @details The last task to finish continues the awaiting coroutine directly on its own thread when it can. All of
+ * the state lives in the awaitable itself, which lives in the awaiting coroutine's frame, so it must be awaited
+ * once it has been created.
+ */
 class ResumeAfter : public Awaitable {
 public:
     template<typename... Args>
     ResumeAfter(ThreadPool *t_threadPool, ThreadType t_threadType, Args... args) :
             Awaitable(t_threadPool, t_threadType) {
-        std::vector<std::shared_ptr<BaseTask>> tasks;
-        tasks.reserve(sizeof...(args));
-        (..., tasks.push_back(args));
-        for (const std::shared_ptr<BaseTask> &dependent : tasks) {
-            if (!*dependent->m_finished) {
-                std::lock_guard<std::mutex> lock(*dependent->m_dependentsMutex);
-                dependent->m_dependents.emplace_back(this);
-                ++*m_dependencyCount;
-            }
-        }
+        (..., addDependency(args));
     }
 
     ResumeAfter(
@@ -44,25 +42,28 @@ public:
       const std::vector<std::shared_ptr<BaseTask>> &t_tasks
     ) :
             Awaitable(t_threadPool, t_threadType) {
-        for (const std::shared_ptr<BaseTask> &dependent : t_tasks)
-            if (!*dependent->m_finished) {
-                std::lock_guard<std::mutex> lock(*dependent->m_dependentsMutex);
-                dependent->m_dependents.emplace_back(this);
-                ++*m_dependencyCount;
-            }
+        for (const std::shared_ptr<BaseTask> &dependency : t_tasks) addDependency(dependency);
     }
 
+    ResumeAfter(const ResumeAfter &) = delete;
+
+    ResumeAfter &operator=(const ResumeAfter &) = delete;
+
     bool await_ready() override;
 
-    void await_suspend(std::coroutine_handle<> t_handle) override;
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> t_handle) override;
+
+    std::coroutine_handle<> releaseDependency() override;
 
-    void releaseDependency() override;
+    /** Also wait for t_task. May only be called before the awaitable is awaited. */
+    void addDependency(const std::shared_ptr<BaseTask> &t_task);
 
     virtual ~ResumeAfter() = default;
 
 protected:
-    std::shared_ptr<std::atomic<std::coroutine_handle<>>> m_handle{
-      std::make_shared<std::atomic<std::coroutine_handle<>>>()};
-    std::shared_ptr<std::atomic<size_t>> m_dependencyCount{std::make_shared<std::atomic<size_t>>()};
+    std::coroutine_handle<> m_handle{};
+    // One for each unfinished dependency, plus one that the awaiting coroutine holds until its handle is stored.
+    // Whoever brings this to zero resumes the coroutine.
+    std::atomic<size_t>     m_dependencyCount{1};
 };
 }  // namespace IE::Core::Threading
\ No newline at end of file
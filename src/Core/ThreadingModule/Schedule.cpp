@@ -0,0 +1,58 @@
+#include "Schedule.hpp"
+
+#include <fstream>
+#include <stdexcept>
+
+IE::Core::Threading::Schedule::Schedule(uint64_t t_seed, std::vector<uint32_t> t_choices) :
+        m_seed(t_seed),
+        m_state(t_seed),
+        m_choices(std::move(t_choices)) {
+}
+
+IE::Core::Threading::Schedule IE::Core::Threading::Schedule::load(const std::filesystem::path &t_path) {
+    std::ifstream file{t_path};
+    uint64_t      seed;
+    if (!(file >> seed)) throw std::runtime_error("failed to read schedule from " + t_path.string() + "!");
+    std::vector<uint32_t> choices;
+    for (uint32_t choice; file >> choice;) choices.push_back(choice);
+    return Schedule{seed, std::move(choices)};
+}
+
+bool IE::Core::Threading::Schedule::save(const std::filesystem::path &t_path) const {
+    std::ofstream file{t_path, std::ios::out | std::ios::trunc};
+    if (!file.is_open()) return false;
+    file << m_seed << '\n';
+    for (std::size_t i{0}; i < m_position; ++i) file << m_choices[i] << (i % 32 == 31 ? '\n' : ' ');
+    file << '\n';
+    return file.good();
+}
+
+uint32_t IE::Core::Threading::Schedule::next(uint32_t t_choiceCount) {
+    if (m_position == m_choices.size()) m_choices.push_back(generate(t_choiceCount));
+    else if (m_choices[m_position] >= t_choiceCount) {
+        // Nothing recorded after this point can be trusted.
+        m_diverged = true;
+        m_choices.resize(m_position);
+        m_choices.push_back(generate(t_choiceCount));
+    }
+    return m_choices[m_position++];
+}
+
+uint64_t IE::Core::Threading::Schedule::seed() const {
+    return m_seed;
+}
+
+const std::vector<uint32_t> &IE::Core::Threading::Schedule::choices() const {
+    return m_choices;
+}
+
+bool IE::Core::Threading::Schedule::diverged() const {
+    return m_diverged;
+}
+
+uint32_t IE::Core::Threading::Schedule::generate(uint32_t t_choiceCount) {
+    uint64_t value = m_state += 0x9E3779B97F4A7C15;
+    value          = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9;
+    value          = (value ^ (value >> 27)) * 0x94D049BB133111EB;
+    return static_cast<uint32_t>((value ^ (value >> 31)) % t_choiceCount);
+}
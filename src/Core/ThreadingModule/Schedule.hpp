@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace IE::Core::Threading {
+/**
+ * @brief The order in which a deterministic thread pool runs its tasks.
+ * @details Every time the pool runs a task, it asks the schedule whether the main thread or which of the workers
+ * should take it, and every time one of those workers steals, which worker it should start stealing from. A
+ * schedule starts out either empty, in which case every choice is generated from its seed, or with the choices of
+ * an earlier run to replay them. Either way, every choice made is recorded so that the run can be saved and
+ * replayed later. If a replayed choice can not be made because there are fewer to choose from than when
+ * it was recorded, the run has diverged from the recording, and the rest of it is generated from the seed.
+ */
+class Schedule {
+public:
+    explicit Schedule(uint64_t t_seed, std::vector<uint32_t> t_choices = {});
+
+    /** Read a schedule written by save(). Throws if the file can not be read. */
+    static Schedule load(const std::filesystem::path &t_path);
+
+    /** @return False if the file could not be written. */
+    bool save(const std::filesystem::path &t_path) const;
+
+    /** @return The index of the choice to make, out of t_choiceCount. */
+    uint32_t next(uint32_t t_choiceCount);
+
+    [[nodiscard]] uint64_t seed() const;
+
+    /** @return The choices made so far, followed by any that are still to be replayed. */
+    [[nodiscard]] const std::vector<uint32_t> &choices() const;
+
+    /** @return True if a replayed choice could not be made. */
+    [[nodiscard]] bool diverged() const;
+
+private:
+    uint64_t              m_seed;
+    // Advanced by every generated choice. SplitMix64 is used rather than a standard distribution, which would
+    // produce different choices on different standard libraries.
+    uint64_t              m_state;
+    std::vector<uint32_t> m_choices;
+    std::size_t           m_position{0};
+    bool                  m_diverged{false};
+
+    uint32_t generate(uint32_t t_choiceCount);
+};
+}  // namespace IE::Core::Threading
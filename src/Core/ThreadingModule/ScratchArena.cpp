@@ -0,0 +1,95 @@
+#include "ScratchArena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+thread_local IE::Core::Threading::ScratchArena *IE::Core::Threading::ScratchArena::m_current{nullptr};
+
+IE::Core::Threading::ScratchArena &IE::Core::Threading::ScratchArena::current() {
+    if (m_current != nullptr) return *m_current;
+    static thread_local ScratchArena arena;
+    return arena;
+}
+
+IE::Core::Threading::ScratchArena::Scope::Scope() :
+        m_arena(&current()),
+        m_blockCount(m_arena->m_blocks.size()),
+        m_position(m_arena->m_position),
+        m_end(m_arena->m_end),
+        m_used(m_arena->m_used.load(std::memory_order_relaxed)) {
+}
+
+IE::Core::Threading::ScratchArena::Scope::~Scope() {
+    // Resetting keeps the blocks that the scope added, coalesced into one, where rewinding would free them.
+    if (m_used == 0) {
+        m_arena->reset();
+        return;
+    }
+    m_arena->finishPeriod();
+    for (std::size_t i = m_blockCount; i < m_arena->m_blocks.size(); ++i)
+        m_arena->m_capacity.fetch_sub(m_arena->m_blocks[i].size, std::memory_order_relaxed);
+    m_arena->m_blocks.resize(m_blockCount);
+    m_arena->m_position = m_position;
+    m_arena->m_end      = m_end;
+    m_arena->m_used.store(m_used, std::memory_order_relaxed);
+}
+
+void IE::Core::Threading::ScratchArena::reset() {
+    finishPeriod();
+    m_used.store(0, std::memory_order_relaxed);
+    if (m_blocks.size() > 1) {
+        // Coalesce the blocks, so that the next time around everything fits in one.
+        m_blocks.clear();
+        addBlock(m_capacity.exchange(0, std::memory_order_relaxed));
+    }
+    if (m_blocks.empty()) return;
+    m_position = m_blocks.front().memory.get();
+    m_end      = m_position + m_blocks.front().size;
+}
+
+IE::Core::Threading::ScratchArena::Statistics IE::Core::Threading::ScratchArena::statistics() const {
+    std::size_t used = m_used.load(std::memory_order_relaxed);
+    return {
+      .used       = used,
+      .lastPeak   = m_lastPeak.load(std::memory_order_relaxed),
+      .highWater  = std::max(used, m_highWater.load(std::memory_order_relaxed)),
+      .capacity   = m_capacity.load(std::memory_order_relaxed),
+      .resetCount = m_resetCount.load(std::memory_order_relaxed)};
+}
+
+void *IE::Core::Threading::ScratchArena::do_allocate(std::size_t t_bytes, std::size_t t_alignment) {
+    auto        address = reinterpret_cast<std::uintptr_t>(m_position);
+    std::size_t padding = (t_alignment - address % t_alignment) % t_alignment;
+    if (m_position == nullptr || static_cast<std::size_t>(m_end - m_position) < padding + t_bytes) {
+        addBlock(t_bytes + t_alignment);
+        address = reinterpret_cast<std::uintptr_t>(m_position);
+        padding = (t_alignment - address % t_alignment) % t_alignment;
+    }
+    std::byte *allocation = m_position + padding;
+    m_position            = allocation + t_bytes;
+    m_used.fetch_add(padding + t_bytes, std::memory_order_relaxed);
+    return allocation;
+}
+
+void IE::Core::Threading::ScratchArena::do_deallocate(void *, std::size_t, std::size_t) {
+}
+
+bool IE::Core::Threading::ScratchArena::do_is_equal(const std::pmr::memory_resource &t_other) const noexcept {
+    return this == &t_other;
+}
+
+void IE::Core::Threading::ScratchArena::finishPeriod() {
+    std::size_t used = m_used.load(std::memory_order_relaxed);
+    m_lastPeak.store(used, std::memory_order_relaxed);
+    if (used > m_highWater.load(std::memory_order_relaxed)) m_highWater.store(used, std::memory_order_relaxed);
+    m_resetCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void IE::Core::Threading::ScratchArena::addBlock(std::size_t t_minimumSize) {
+    // Grow geometrically so that a burst of allocations only adds a few blocks.
+    std::size_t size = std::max({t_minimumSize, MIN_BLOCK_SIZE, m_capacity.load(std::memory_order_relaxed)});
+    m_blocks.push_back({std::make_unique_for_overwrite<std::byte[]>(size), size});
+    m_position = m_blocks.back().memory.get();
+    m_end      = m_position + size;
+    m_capacity.fetch_add(size, std::memory_order_relaxed);
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "Awaitable.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace IE::Core::Threading {
+/**
+ * @brief A bump allocator for short-lived memory, usable as a std::pmr::memory_resource.
+ * @details Allocating only moves a pointer, and deallocating does nothing. Everything is freed at once by reset(),
+ * which workers call whenever they finish a task, so scratch memory must not be kept past the end of the task or
+ * across a co_await. Tasks that never finish, such as the game loop, free the memory of each of their iterations
+ * with a Scope instead, as IERenderEngine::update() does for every frame. When the arena runs out it grows by
+ * adding another block. The next reset() replaces all of the blocks with a single one big enough for all of them,
+ * so that a steady workload settles into one block.
+ */
+class ScratchArena : public std::pmr::memory_resource {
+public:
+    static constexpr std::size_t MIN_BLOCK_SIZE{64 * 1024};
+
+    struct Statistics {
+        std::size_t used;       // Bytes allocated since the last reset.
+        std::size_t lastPeak;   // Bytes that were allocated when the arena was last reset or a scope of it ended.
+        std::size_t highWater;  // The most bytes that were ever allocated between two resets.
+        std::size_t capacity;   // Bytes reserved from the system.
+        std::size_t resetCount;
+    };
+
+    /**
+     * @brief Frees everything allocated from the calling thread's arena during its lifetime once it is destroyed.
+     * @details Anything allocated before the scope began is left alone. A scope that begins while nothing is
+     * allocated resets the arena when it ends. Scopes must be destroyed on the thread that created them, in the
+     * reverse order of their creation, and the arena must not be reset while one is alive.
+     */
+    class Scope {
+    public:
+        Scope();
+
+        Scope(const Scope &) = delete;
+
+        Scope &operator=(const Scope &) = delete;
+
+        ~Scope();
+
+    private:
+        ScratchArena *m_arena;
+        std::size_t   m_blockCount;
+        std::byte    *m_position;
+        std::byte    *m_end;
+        std::size_t   m_used;
+    };
+
+    ScratchArena() = default;
+
+    ScratchArena(const ScratchArena &) = delete;
+
+    ScratchArena &operator=(const ScratchArena &) = delete;
+
+    /** @return The calling thread's scratch arena. Threads outside of any thread pool get one of their own. */
+    static ScratchArena &current();
+
+    /** Free everything allocated from this arena. May only be called from the thread that the arena belongs to. */
+    void reset();
+
+    /** May be called from any thread. */
+    [[nodiscard]] Statistics statistics() const;
+
+protected:
+    void *do_allocate(std::size_t t_bytes, std::size_t t_alignment) override;
+
+    void do_deallocate(void *t_pointer, std::size_t t_bytes, std::size_t t_alignment) override;
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &t_other) const noexcept override;
+
+private:
+    struct Block {
+        std::unique_ptr<std::byte[]> memory;
+        std::size_t                  size;
+    };
+
+    std::vector<Block>       m_blocks;
+    std::byte               *m_position{};
+    std::byte               *m_end{};
+    // The owning thread writes these, other threads may read them.
+    std::atomic<std::size_t> m_used{0};
+    std::atomic<std::size_t> m_lastPeak{0};
+    std::atomic<std::size_t> m_highWater{0};
+    std::atomic<std::size_t> m_capacity{0};
+    std::atomic<std::size_t> m_resetCount{0};
+
+    // Set by thread pool threads to the arena that the pool owns for them.
+    static thread_local ScratchArena *m_current;
+
+    void addBlock(std::size_t t_minimumSize);
+
+    /** Record the statistics of the period that a reset or the end of a scope finishes. */
+    void finishPeriod();
+
+    friend class ThreadPool;
+    friend class Worker;
+};
+
+/** Never suspends. Resumes with the scratch arena of the thread that the awaiting coroutine is running on. */
+struct ScratchArenaAccess {
+    bool await_ready() noexcept {
+        return true;
+    }
+
+    void await_suspend(std::coroutine_handle<>) noexcept {
+    }
+
+    ScratchArena &await_resume() {
+        return ScratchArena::current();
+    }
+};
+}  // namespace IE::Core::Threading
@@ -0,0 +1,25 @@
+#include "Sleep.hpp"
+
+#include "ThreadPool.hpp"
+
+IE::Core::Threading::Sleep::Sleep(
+  IE::Core::Threading::ThreadPool      *t_threadPool,
+  IE::Core::Threading::ThreadType       t_threadType,
+  std::chrono::steady_clock::time_point t_deadline
+) :
+        Awaitable(t_threadPool, t_threadType),
+        m_deadline(t_deadline) {
+}
+
+bool IE::Core::Threading::Sleep::await_ready() {
+    return std::chrono::steady_clock::now() >= m_deadline;
+}
+
+std::coroutine_handle<> IE::Core::Threading::Sleep::await_suspend(std::coroutine_handle<> t_handle) {
+    m_threadPool->getReactor().addTimer(m_deadline, {t_handle, m_threadType, m_priority});
+    return std::noop_coroutine();
+}
+
+std::coroutine_handle<> IE::Core::Threading::Sleep::releaseDependency() {
+    return nullptr;
+}
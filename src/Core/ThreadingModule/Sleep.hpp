@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Awaitable.hpp"
+
+#include <chrono>
+
+namespace IE::Core::Threading {
+class ThreadPool;
+
+/** Suspends the awaiting coroutine until a point in time, without holding a worker thread. */
+class Sleep : public Awaitable {
+public:
+    Sleep(ThreadPool *t_threadPool, ThreadType t_threadType, std::chrono::steady_clock::time_point t_deadline);
+
+    bool await_ready() override;
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> t_handle) override;
+
+    std::coroutine_handle<> releaseDependency() override;
+
+    virtual ~Sleep() = default;
+
+protected:
+    std::chrono::steady_clock::time_point m_deadline;
+};
+}  // namespace IE::Core::Threading
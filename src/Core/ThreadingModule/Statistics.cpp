@@ -0,0 +1,111 @@
+#include "Statistics.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+
+thread_local IE::Core::Threading::ThreadStatistics *IE::Core::Threading::ThreadStatistics::m_current{nullptr};
+
+IE::Core::Threading::LatencyHistogram::LatencyHistogram(const IE::Core::Threading::LatencyHistogram &t_other) {
+    merge(t_other);
+}
+
+IE::Core::Threading::LatencyHistogram &
+IE::Core::Threading::LatencyHistogram::operator=(const IE::Core::Threading::LatencyHistogram &t_other) {
+    if (this == &t_other) return *this;
+    for (uint32_t i{0}; i < BUCKET_COUNT; ++i)
+        m_buckets[i].store(t_other.m_buckets[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    return *this;
+}
+
+void IE::Core::Threading::LatencyHistogram::record(uint64_t t_nanoseconds) {
+    std::atomic<uint64_t> &bucket = m_buckets[bucketOf(t_nanoseconds)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void IE::Core::Threading::LatencyHistogram::merge(const IE::Core::Threading::LatencyHistogram &t_other) {
+    for (uint32_t i{0}; i < BUCKET_COUNT; ++i)
+        m_buckets[i].fetch_add(t_other.m_buckets[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+uint64_t IE::Core::Threading::LatencyHistogram::count() const {
+    uint64_t count{0};
+    for (const std::atomic<uint64_t> &bucket : m_buckets) count += bucket.load(std::memory_order_relaxed);
+    return count;
+}
+
+uint64_t IE::Core::Threading::LatencyHistogram::percentile(double t_percentile) const {
+    uint64_t total = count();
+    if (total == 0) return 0;
+    auto target = static_cast<uint64_t>(std::clamp(t_percentile, 0.0, 100.0) / 100.0 * static_cast<double>(total));
+    uint64_t seen{0};
+    for (uint32_t i{0}; i < BUCKET_COUNT; ++i) {
+        seen += m_buckets[i].load(std::memory_order_relaxed);
+        if (seen > target || seen == total) return upperBoundOf(i);
+    }
+    return upperBoundOf(BUCKET_COUNT - 1);
+}
+
+uint32_t IE::Core::Threading::LatencyHistogram::bucketOf(uint64_t t_nanoseconds) {
+    t_nanoseconds = std::min(t_nanoseconds, (uint64_t{1} << MAX_MAGNITUDE) - 1);
+    // Below 2 * SUB_BUCKET_COUNT every value gets its own bucket. Above that, each power of two is split into
+    // SUB_BUCKET_COUNT buckets by keeping only the SUB_BUCKET_BITS bits after the leading one.
+    if (t_nanoseconds < 2 * SUB_BUCKET_COUNT) return static_cast<uint32_t>(t_nanoseconds);
+    uint32_t shift = std::bit_width(t_nanoseconds) - SUB_BUCKET_BITS - 1;
+    return (shift + 1) * SUB_BUCKET_COUNT + static_cast<uint32_t>(t_nanoseconds >> shift) - SUB_BUCKET_COUNT;
+}
+
+uint64_t IE::Core::Threading::LatencyHistogram::upperBoundOf(uint32_t t_bucket) {
+    if (t_bucket < 2 * SUB_BUCKET_COUNT) return t_bucket;
+    uint32_t shift = t_bucket / SUB_BUCKET_COUNT - 1;
+    uint64_t first = static_cast<uint64_t>(t_bucket % SUB_BUCKET_COUNT + SUB_BUCKET_COUNT) << shift;
+    return first + (uint64_t{1} << shift) - 1;
+}
+
+std::string IE::Core::Threading::ThreadPoolStatistics::toString() const {
+    auto milliseconds = [](uint64_t t_nanoseconds) { return static_cast<double>(t_nanoseconds) / 1e6; };
+    char line[256];
+    std::snprintf(
+      line,
+      sizeof(line),
+      "Queues: critical %zu, normal %zu, background %zu, main %zu\n",
+      queueDepths[IE_TASK_PRIORITY_FRAME_CRITICAL],
+      queueDepths[IE_TASK_PRIORITY_NORMAL],
+      queueDepths[IE_TASK_PRIORITY_BACKGROUND],
+      mainQueueDepth
+    );
+    std::string result{line};
+    for (std::size_t i{0}; i < threads.size(); ++i) {
+        const Thread &thread = threads[i];
+        uint64_t      total  = thread.busyNanoseconds + thread.idleNanoseconds;
+        std::snprintf(
+          line,
+          sizeof(line),
+          "%s %zu: %5.1f%% busy, %llu tasks, %llu steals, %llu wakeups, %zu queued\n",
+          i == 0 ? "Main thread" : "Worker",
+          i == 0 ? 0 : i - 1,
+          total == 0 ? 0.0 : 100.0 * static_cast<double>(thread.busyNanoseconds) / static_cast<double>(total),
+          static_cast<unsigned long long>(thread.tasksExecuted),
+          static_cast<unsigned long long>(thread.steals),
+          static_cast<unsigned long long>(thread.wakeups),
+          i == 0 || i - 1 >= dequeDepths.size() ? 0 : dequeDepths[i - 1]
+        );
+        result += line;
+    }
+    for (const auto &[name, histogram] :
+         {std::pair{"Queue latency", &queueLatency}, std::pair{"Execution latency", &executionLatency}}) {
+        std::snprintf(
+          line,
+          sizeof(line),
+          "%s: p50 %.3fms, p90 %.3fms, p99 %.3fms, max %.3fms over %llu tasks\n",
+          name,
+          milliseconds(histogram->percentile(50)),
+          milliseconds(histogram->percentile(90)),
+          milliseconds(histogram->percentile(99)),
+          milliseconds(histogram->percentile(100)),
+          static_cast<unsigned long long>(histogram->count())
+        );
+        result += line;
+    }
+    return result;
+}
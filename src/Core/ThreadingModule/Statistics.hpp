@@ -0,0 +1,182 @@
+#pragma once
+
+#include "BaseTask.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+ * Thread pool statistics are only collected when IE_THREADING_STATISTICS is defined. Otherwise every recording
+ * function below is empty, and the counters are never added to the pool.
+ */
+
+namespace IE::Core::Threading {
+/**
+ * @brief A histogram of durations in nanoseconds with a bounded relative error, in the style of an HDR histogram.
+ * @details Each power of two is split into SUB_BUCKET_COUNT linear buckets, so any recorded duration is reported
+ * within about 6% of its true value. Only one thread may record into a histogram, but any thread may read it.
+ */
+class LatencyHistogram {
+public:
+    static constexpr uint32_t SUB_BUCKET_BITS{4};
+    static constexpr uint32_t SUB_BUCKET_COUNT{1U << SUB_BUCKET_BITS};
+    static constexpr uint32_t MAX_MAGNITUDE{40};  // Durations are clamped to 2^40 ns, or about 18 minutes.
+    static constexpr uint32_t BUCKET_COUNT{(MAX_MAGNITUDE - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT};
+
+    LatencyHistogram() = default;
+
+    LatencyHistogram(const LatencyHistogram &t_other);
+
+    LatencyHistogram &operator=(const LatencyHistogram &t_other);
+
+    void record(uint64_t t_nanoseconds);
+
+    void merge(const LatencyHistogram &t_other);
+
+    [[nodiscard]] uint64_t count() const;
+
+    /** @return The duration in nanoseconds that t_percentile percent of the recorded durations do not exceed. */
+    [[nodiscard]] uint64_t percentile(double t_percentile) const;
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> m_buckets{};
+
+    static uint32_t bucketOf(uint64_t t_nanoseconds);
+
+    /** @return The largest duration that falls into t_bucket. */
+    static uint64_t upperBoundOf(uint32_t t_bucket);
+};
+
+/** Counters for one thread of a thread pool. Only that thread writes to them, but any thread may read them. */
+class ThreadStatistics {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    std::atomic<uint64_t> busyNanoseconds{0};
+    std::atomic<uint64_t> idleNanoseconds{0};
+    std::atomic<uint64_t> tasksExecuted{0};
+    std::atomic<uint64_t> steals{0};
+    std::atomic<uint64_t> wakeups{0};
+    // From a task being submitted to it starting, and from it starting to it finishing.
+    LatencyHistogram      queueLatency;
+    LatencyHistogram      executionLatency;
+
+    /** Add t_amount to one of the calling thread's counters. */
+    static void count(std::atomic<uint64_t> ThreadStatistics::*t_counter, uint64_t t_amount = 1);
+
+    /** @return The current time, or a default constructed time point if statistics are disabled. */
+    static Clock::time_point now();
+
+    /** Add the time between t_start and t_end to one of the calling thread's counters. */
+    static void countTime(
+      std::atomic<uint64_t> ThreadStatistics::*t_counter,
+      Clock::time_point                        t_start,
+      Clock::time_point                        t_end
+    );
+
+    static void taskSubmitted(BaseTask &t_task);
+
+    /** Record how long t_task waited, the first time that it starts running. */
+    static void taskStarted(BaseTask &t_task);
+
+    static void taskFinished(BaseTask &t_task);
+
+private:
+    // Set by thread pool threads to the statistics that the pool keeps for them.
+    static thread_local ThreadStatistics *m_current;
+
+    static void add(std::atomic<uint64_t> &t_counter, uint64_t t_amount);
+
+    friend class ThreadPool;
+    friend class Worker;
+};
+
+/** A snapshot of a thread pool's statistics. */
+struct ThreadPoolStatistics {
+    struct Thread {
+        uint64_t busyNanoseconds;
+        uint64_t idleNanoseconds;
+        uint64_t tasksExecuted;
+        uint64_t steals;
+        uint64_t wakeups;
+    };
+
+    // The main thread, followed by each worker slot in use. Empty if statistics are disabled.
+    std::vector<Thread>        threads;
+    // The number of tasks waiting in each of the shared priority queues, and in the main thread's queue.
+    std::array<std::size_t, 3> queueDepths;
+    std::size_t                mainQueueDepth;
+    // The number of tasks waiting in the deque of each worker slot in use.
+    std::vector<std::size_t>   dequeDepths;
+    // Merged over every thread.
+    LatencyHistogram           queueLatency;
+    LatencyHistogram           executionLatency;
+
+    /** @return A human readable summary, one line per thread. */
+    [[nodiscard]] std::string toString() const;
+};
+
+inline void ThreadStatistics::add(std::atomic<uint64_t> &t_counter, uint64_t t_amount) {
+    // Only the owning thread writes, so there is no need for an atomic read-modify-write.
+    t_counter.store(t_counter.load(std::memory_order_relaxed) + t_amount, std::memory_order_relaxed);
+}
+
+// The parameters below go unused in builds without IE_THREADING_STATISTICS.
+inline void ThreadStatistics::count(
+  [[maybe_unused]] std::atomic<uint64_t> ThreadStatistics::*t_counter,
+  [[maybe_unused]] uint64_t                                 t_amount
+) {
+#if defined(IE_THREADING_STATISTICS)
+    if (m_current != nullptr) add(m_current->*t_counter, t_amount);
+#endif
+}
+
+inline ThreadStatistics::Clock::time_point ThreadStatistics::now() {
+#if defined(IE_THREADING_STATISTICS)
+    return Clock::now();
+#else
+    return {};
+#endif
+}
+
+inline void ThreadStatistics::countTime(
+  [[maybe_unused]] std::atomic<uint64_t> ThreadStatistics::*t_counter,
+  [[maybe_unused]] Clock::time_point                        t_start,
+  [[maybe_unused]] Clock::time_point                        t_end
+) {
+#if defined(IE_THREADING_STATISTICS)
+    count(t_counter, std::chrono::duration_cast<std::chrono::nanoseconds>(t_end - t_start).count());
+#endif
+}
+
+inline void ThreadStatistics::taskSubmitted([[maybe_unused]] BaseTask &t_task) {
+#if defined(IE_THREADING_STATISTICS)
+    t_task.m_submitTime = Clock::now();
+#endif
+}
+
+inline void ThreadStatistics::taskStarted([[maybe_unused]] BaseTask &t_task) {
+#if defined(IE_THREADING_STATISTICS)
+    if (t_task.m_startTime != Clock::time_point{}) return;
+    t_task.m_startTime = Clock::now();
+    if (m_current == nullptr || t_task.m_submitTime == Clock::time_point{}) return;
+    m_current->queueLatency.record(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(t_task.m_startTime - t_task.m_submitTime).count()
+    );
+#endif
+}
+
+inline void ThreadStatistics::taskFinished([[maybe_unused]] BaseTask &t_task) {
+#if defined(IE_THREADING_STATISTICS)
+    if (m_current == nullptr || t_task.m_startTime == Clock::time_point{}) return;
+    m_current->executionLatency.record(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t_task.m_startTime).count()
+    );
+#endif
+}
+}  // namespace IE::Core::Threading
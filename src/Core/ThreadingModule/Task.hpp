@@ -1,7 +1,10 @@
 #pragma once
 
+#include "Allocator.hpp"
 #include "Awaitable.hpp"
 #include "BaseTask.hpp"
+#include "CancellationToken.hpp"
+#include "Tracer.hpp"
 
 #include <type_traits>
 
@@ -10,6 +13,7 @@
 
 namespace std {
 using std::experimental::coroutine_handle;
+using std::experimental::noop_coroutine;
 using std::experimental::suspend_always;
 using std::experimental::suspend_never;
 }  // namespace std
@@ -17,6 +21,7 @@ using std::experimental::suspend_never;
 #    include <coroutine>
 #endif
 #include <functional>
+#include <memory>
 #include <mutex>
 
 namespace IE::Core::Threading {
@@ -38,9 +43,67 @@ struct Member {
     T m_value;
 };
 
+/** Wraps every awaitable that a task co_awaits, making each co_await a cancellation point. */
+template<typename A>
+struct CancellationPoint {
+    A        &awaitable;
+    BaseTask *task;
+    void     *frame{nullptr};  // Set if the coroutine suspended, to end the tracer's flow arrow when it resumes.
+
+    bool await_ready() {
+        return awaitable.await_ready();
+    }
+
+    template<typename P>
+    decltype(auto) await_suspend(std::coroutine_handle<P> t_handle) {
+        frame = t_handle.address();
+        return awaitable.await_suspend(t_handle);
+    }
+
+    decltype(auto) await_resume() {
+        // The coroutine may have been resumed by another task, so make sure that work it submits inherits from it.
+        BaseTask::m_current = task;
+        if (frame != nullptr) Tracer::flowEnd(frame);
+        if (task->m_cancellationToken.cancelled()) throw TaskCancelled{};
+        return awaitable.await_resume();
+    }
+};
+
+/** Finishes the task once its coroutine is done, then transfers straight to the dependent that it released. */
+template<typename T>
+struct FinalAwaiter {
+    bool await_ready() noexcept {
+        return false;
+    }
+
+    template<typename P>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<P> t_handle) noexcept {
+        // Waiters may let go of the task as soon as it is marked as finished, so hold on to it until it returns.
+        std::shared_ptr<Task<T>> task{std::move(t_handle.promise().owner)};
+        std::coroutine_handle<> continuation = task->finish();
+        // This awaiter lives in the frame, so nothing may touch it from here on.
+        t_handle.destroy();
+        return continuation ? continuation : std::noop_coroutine();
+    }
+
+    void await_resume() noexcept {
+    }
+};
+
 template<typename T>
 struct promise_type {
     Task<T> *parent;
+    // A submitted task is kept alive by its own coroutine until the coroutine has finished.
+    std::shared_ptr<Task<T>> owner;
+
+    // Coroutine frames come from the per-thread task pool rather than the global heap.
+    static void *operator new(std::size_t t_size) {
+        return ThreadCache::allocate(t_size);
+    }
+
+    static void operator delete(void *t_pointer, std::size_t t_size) noexcept {
+        ThreadCache::deallocate(t_pointer, t_size);
+    }
 
     Task<T> get_return_object();
 
@@ -48,10 +111,22 @@ struct promise_type {
         return {};
     }
 
-    std::suspend_never final_suspend() noexcept;
+    FinalAwaiter<T> final_suspend() noexcept {
+        return {};
+    }
+
+    template<typename A>
+    CancellationPoint<std::remove_reference_t<A>> await_transform(A &&t_awaitable) {
+        return {t_awaitable, parent};
+    }
 
     void unhandled_exception() {
-        std::rethrow_exception(std::current_exception());
+        try {
+            throw;
+        } catch (const TaskCancelled &) {
+            // Cancellation unwinds the coroutine to its final suspend point, where the task finishes as usual.
+            parent->m_cancelled = true;
+        }
     }
 
     operator T();
@@ -84,11 +159,22 @@ public:
     }
 
     void execute() override {
+        if (m_cancellationToken.cancelled()) return cancel();
         m_handle.resume();
     }
 
-    void connectHandle() {
-        m_handle.promise().parent = this;
+    void abandon() override {
+        // The coroutine frame holds on to its own task, so it has to be destroyed for either of them to be freed.
+        std::shared_ptr<Task> task{std::move(m_handle.promise().owner)};
+        m_cancelled = true;
+        m_handle.destroy();
+        m_finished.store(true, std::memory_order_release);
+        m_finished.notify_all();
+    }
+
+    static void connectHandle(const std::shared_ptr<Task> &t_task) {
+        t_task->m_handle.promise().parent = t_task.get();
+        t_task->m_handle.promise().owner  = t_task;
     }
 
     ReturnType value() {
@@ -96,6 +182,13 @@ public:
             return detail::ConditionalInheritance<detail::Member<T>, not std::is_void_v<T>>::m_value;
     }
 
+    /** @return The value without copying it. Valid for as long as the task is. */
+    template<typename U = ReturnType>
+        requires(not std::is_void_v<U>)
+    const U &valueReference() const {
+        return this->m_value;
+    }
+
     operator ReturnType() {
         return value();
     }
@@ -103,6 +196,14 @@ public:
 private:
     std::coroutine_handle<promise_type> m_handle;
 
+    /** Finish a task that was cancelled before it started, freeing its coroutine frame without running it. */
+    void cancel() {
+        std::shared_ptr<Task> task{std::move(m_handle.promise().owner)};
+        m_cancelled = true;
+        m_handle.destroy();
+        if (std::coroutine_handle<> continuation = finish()) continuation.resume();
+    }
+
     friend detail::return_promise_type<ReturnType, true>;
 };  // namespace IE::Core::Threading
 
@@ -113,18 +214,6 @@ Task<T> detail::promise_type<T>::get_return_object() {
     )};
 }
 
-template<typename T>
-std::suspend_never detail::promise_type<T>::final_suspend() noexcept {
-    {
-        std::lock_guard<std::mutex> lock{*parent->m_dependentsMutex};
-        for (Awaitable *dependent : parent->m_dependents) dependent->releaseDependency();
-    }
-    parent->m_dependents.clear();
-    *parent->m_finished = true;
-    parent->m_finishedNotifier->notify_all();
-    return {};
-}
-
 template<typename T, bool B>
 void detail::return_promise_type<T, B>::return_value(T t_value) {
     promise_type<T>::parent->m_value = t_value;
@@ -0,0 +1,213 @@
+#include "TaskGraph.hpp"
+
+#include "ThreadPool.hpp"
+#include "Tracer.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+/** Suspends the task that runs the graph until every node has finished. */
+class IE::Core::Threading::TaskGraph::Completion : public Awaitable {
+public:
+    explicit Completion(TaskGraph *t_graph) :
+            Awaitable(t_graph->m_threadPool, IE_THREAD_TYPE_WORKER_THREAD),
+            m_graph(t_graph) {
+    }
+
+    bool await_ready() override {
+        return false;
+    }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> t_handle) override {
+        // The handle is published before this task gives up its share of the count, so whoever brings the count to
+        // zero is guaranteed to see it.
+        m_graph->m_continuation = t_handle;
+        // If every node has already finished, carry straight on.
+        if (m_graph->m_remainingCount.fetch_sub(1, std::memory_order_acq_rel) == 1) return t_handle;
+        return std::noop_coroutine();
+    }
+
+    std::coroutine_handle<> releaseDependency() override {
+        return nullptr;
+    }
+
+private:
+    TaskGraph *m_graph;
+};
+
+IE::Core::Threading::TaskGraph::TaskGraph(IE::Core::Threading::ThreadPool *t_threadPool) :
+        m_threadPool(t_threadPool) {
+}
+
+IE::Core::Threading::TaskGraph::NodeID IE::Core::Threading::TaskGraph::addNode(
+  std::string                       t_name,
+  std::function<void()>             t_job,
+  IE::Core::Threading::ThreadType   t_threadType,
+  IE::Core::Threading::TaskPriority t_priority
+) {
+    m_nodes.emplace_back(std::move(t_name), std::move(t_job), t_threadType, t_priority);
+    m_compiled = false;
+    return m_nodes.size() - 1;
+}
+
+void IE::Core::Threading::TaskGraph::addDependency(NodeID t_node, NodeID t_dependency) {
+    if (t_node >= m_nodes.size() || t_dependency >= m_nodes.size())
+        throw std::out_of_range("task graph dependency refers to a node that does not exist!");
+    m_nodes[t_dependency].successors.push_back(t_node);
+    ++m_nodes[t_node].dependencyCount;
+    m_compiled = false;
+}
+
+void IE::Core::Threading::TaskGraph::compile() {
+    // Kahn's algorithm. m_order doubles as the queue of nodes whose dependencies have all been placed.
+    std::vector<uint32_t> unplacedDependencyCount(m_nodes.size());
+    m_order.clear();
+    m_order.reserve(m_nodes.size());
+    m_sources.clear();
+    for (NodeID i{0}; i < m_nodes.size(); ++i) {
+        unplacedDependencyCount[i] = m_nodes[i].dependencyCount;
+        if (unplacedDependencyCount[i] == 0) {
+            m_sources.push_back(i);
+            m_order.push_back(i);
+        }
+    }
+    for (std::size_t i{0}; i < m_order.size(); ++i)
+        for (NodeID successor : m_nodes[m_order[i]].successors)
+            if (--unplacedDependencyCount[successor] == 0) m_order.push_back(successor);
+    if (m_order.size() != m_nodes.size()) throw std::runtime_error("task graph dependencies form a cycle!");
+    m_compiled = true;
+}
+
+std::shared_ptr<IE::Core::Threading::Task<void>> IE::Core::Threading::TaskGraph::run() {
+    if (!m_compiled) compile();
+    return m_threadPool->submit(IE_THREAD_TYPE_WORKER_THREAD, execute());
+}
+
+void IE::Core::Threading::TaskGraph::runAndWait() {
+    // A deterministic pool has to let its schedule pick every task that it runs, main thread nodes included.
+    if (m_threadPool->thisThreadType() != IE_THREAD_TYPE_MAIN_THREAD || m_threadPool->deterministic())
+        return Worker::waitForTask(m_threadPool, *run());
+    if (!m_compiled) compile();
+    m_runningInline = true;
+    m_continuation  = nullptr;
+    start();
+    // Nothing waits to be resumed, so this thread gives up its share of the count straight away.
+    finishOne();
+    Node *node;
+    while (true) {
+        // Read the epoch before checking, so that a node or finish published after the check wakes this thread.
+        uint32_t epoch = m_laneEpoch.load(std::memory_order_acquire);
+        if (m_mainThreadLane.pop(node)) runNode(*node);
+        else if (m_remainingCount.load(std::memory_order_acquire) == 0) break;
+        else m_laneEpoch.wait(epoch, std::memory_order_acquire);
+    }
+    m_runningInline = false;
+}
+
+std::vector<IE::Core::Threading::TaskGraph::NodeTiming> IE::Core::Threading::TaskGraph::timings() const {
+    std::vector<NodeTiming> timings;
+    timings.reserve(m_nodes.size());
+    for (const Node &node : m_nodes) {
+        timings.push_back(
+          {.name           = node.name,
+           .start          = std::chrono::duration<double>(node.start - m_runStart).count(),
+           .duration       = std::chrono::duration<double>(node.end - node.start).count(),
+           .onCriticalPath = false}
+        );
+    }
+    for (NodeID node : criticalPath()) timings[node].onCriticalPath = true;
+    return timings;
+}
+
+std::vector<IE::Core::Threading::TaskGraph::NodeID> IE::Core::Threading::TaskGraph::criticalPath() const {
+    if (!m_compiled || m_order.empty()) return {};
+    // Walk the nodes in topological order, finding the longest chain of durations that ends at each one.
+    std::vector<Clock::duration> chainLength(m_nodes.size(), Clock::duration::zero());
+    std::vector<NodeID>          previous(m_nodes.size());
+    for (NodeID i{0}; i < m_nodes.size(); ++i) previous[i] = i;
+    NodeID last = m_order.front();
+    for (NodeID node : m_order) {
+        chainLength[node] += m_nodes[node].end - m_nodes[node].start;
+        if (chainLength[node] > chainLength[last]) last = node;
+        for (NodeID successor : m_nodes[node].successors) {
+            if (chainLength[node] <= chainLength[successor]) continue;
+            chainLength[successor] = chainLength[node];
+            previous[successor]    = node;
+        }
+    }
+    std::vector<NodeID> path{last};
+    while (previous[path.back()] != path.back()) path.push_back(previous[path.back()]);
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+std::string IE::Core::Threading::TaskGraph::timingReport() const {
+    std::string result;
+    char        line[256];
+    for (const NodeTiming &timing : timings()) {
+        std::snprintf(
+          line,
+          sizeof(line),
+          "%s: %.3f ms after the start, took %.3f ms%s\n",
+          timing.name.c_str(),
+          timing.start * 1000.0,
+          timing.duration * 1000.0,
+          timing.onCriticalPath ? ", on the critical path" : ""
+        );
+        result += line;
+    }
+    return result;
+}
+
+void IE::Core::Threading::TaskGraph::start() {
+    m_runStart = Clock::now();
+    m_remainingCount.store(m_nodes.size() + 1, std::memory_order_relaxed);
+    for (Node &node : m_nodes) node.pendingDependencyCount.store(node.dependencyCount, std::memory_order_relaxed);
+    for (NodeID source : m_sources) submitNode(m_nodes[source]);
+}
+
+IE::Core::Threading::Task<void> IE::Core::Threading::TaskGraph::execute() {
+    start();
+    co_await Completion{this};
+}
+
+IE::Core::Threading::Task<void> IE::Core::Threading::TaskGraph::executeNode(Node &t_node) {
+    runNode(t_node);
+    co_return;
+}
+
+void IE::Core::Threading::TaskGraph::runNode(Node &t_node) {
+    {
+        // Node names live as long as the graph, which is long enough for the tracer.
+        Tracer::Zone zone{t_node.name.c_str(), &t_node};
+        t_node.start = Clock::now();
+        t_node.job();
+        t_node.end = Clock::now();
+    }
+    for (NodeID successor : t_node.successors)
+        if (m_nodes[successor].pendingDependencyCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            submitNode(m_nodes[successor]);
+    finishOne();
+}
+
+void IE::Core::Threading::TaskGraph::submitNode(Node &t_node) {
+    if (m_runningInline && t_node.threadType == IE_THREAD_TYPE_MAIN_THREAD) {
+        m_mainThreadLane.push(&t_node);
+        m_laneEpoch.fetch_add(1, std::memory_order_release);
+        m_laneEpoch.notify_one();
+        return;
+    }
+    // Nodes ignore cancellation, as a node that never ran would leave the run waiting forever.
+    m_threadPool->submit(CancellationToken{}, t_node.threadType, t_node.priority, executeNode(t_node));
+}
+
+void IE::Core::Threading::TaskGraph::finishOne() {
+    // Once the count reaches zero, runAndWait() may return and start another run, so read the mode before that.
+    bool runningInline = m_runningInline;
+    if (m_remainingCount.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+    if (runningInline) {
+        m_laneEpoch.fetch_add(1, std::memory_order_release);
+        m_laneEpoch.notify_one();
+    } else m_threadPool->submit(IE_THREAD_TYPE_WORKER_THREAD, m_continuation);
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "Awaitable.hpp"
+#include "Queue.hpp"
+#include "Task.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace IE::Core::Threading {
+class ThreadPool;
+
+/**
+ * @brief A reusable graph of jobs with explicit dependencies between them.
+ * @details The graph is declared once with addNode() and addDependency(), then compiled into a topological
+ * schedule. Every call to run() executes the whole graph again. Nodes are never reallocated between runs, and each
+ * node tracks its dependencies with a single counter, so a run takes no locks and allocates nothing but the tasks
+ * that execute the nodes. The start time and duration of every node in the most recent run are recorded so that
+ * the critical path can be inspected. Each node is also recorded by the Tracer as a zone named after it, so a
+ * graph must not be destroyed before a trace that it ran in has been written.
+ * @note A graph must not be modified or run again until its previous run has finished.
+ */
+class TaskGraph {
+public:
+    using NodeID = uint32_t;
+
+    struct NodeTiming {
+        std::string name;
+        double      start;     // Seconds since the start of the run.
+        double      duration;  // Seconds.
+        bool        onCriticalPath;
+    };
+
+    explicit TaskGraph(ThreadPool *t_threadPool);
+
+    TaskGraph(const TaskGraph &) = delete;
+
+    TaskGraph &operator=(const TaskGraph &) = delete;
+
+    NodeID addNode(
+      std::string           t_name,
+      std::function<void()> t_job,
+      ThreadType            t_threadType = IE_THREAD_TYPE_WORKER_THREAD,
+      TaskPriority          t_priority   = IE_TASK_PRIORITY_NORMAL
+    );
+
+    /**
+     * @brief Make t_node wait for t_dependency to finish before it starts.
+     * @details Throws std::out_of_range if either of them is not a node of this graph.
+     */
+    void addDependency(NodeID t_node, NodeID t_dependency);
+
+    /** Order the nodes topologically. Throws std::runtime_error if the dependencies form a cycle. */
+    void compile();
+
+    /**
+     * @brief Run every node once, compiling the graph first if it has changed.
+     * @return A task that finishes once every node has finished.
+     */
+    std::shared_ptr<Task<void>> run();
+
+    /**
+     * @brief Run every node once, returning once all of them have finished.
+     * @details Meant for the pool's main thread, which runs the nodes pinned to the main thread itself as soon as
+     * they are ready, from a lane of the graph's own. Nothing else is taken from the pool's main thread queue in
+     * the meantime, so other main thread work keeps waiting for ThreadPool::pumpMainThread(). Nodes must
+     * therefore never wait for other main thread work. Called from any other thread, or on a deterministic pool,
+     * this runs the graph like run() and waits for it with Worker::waitForTask().
+     */
+    void runAndWait();
+
+    /** @return The timing of every node in the most recent run, indexed by NodeID. */
+    [[nodiscard]] std::vector<NodeTiming> timings() const;
+
+    /** @return The longest chain of dependent nodes in the most recent run, in execution order. */
+    [[nodiscard]] std::vector<NodeID> criticalPath() const;
+
+    /** @return One line per node with its timing in the most recent run, marking those on the critical path. */
+    [[nodiscard]] std::string timingReport() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Node {
+        std::string           name;
+        std::function<void()> job;
+        ThreadType            threadType;
+        TaskPriority          priority;
+        std::vector<NodeID>   successors{};
+        uint32_t              dependencyCount{0};
+        std::atomic<uint32_t> pendingDependencyCount{0};
+        Clock::time_point     start{};
+        Clock::time_point     end{};
+    };
+
+    class Completion;
+
+    ThreadPool             *m_threadPool;
+    // A deque so that nodes, which can not be moved, are never relocated as more are added.
+    std::deque<Node>        m_nodes;
+    std::vector<NodeID>     m_order;
+    std::vector<NodeID>     m_sources;
+    bool                    m_compiled{false};
+    // The number of nodes left to finish in the current run, plus one for the task that waits on them.
+    std::atomic<uint32_t>   m_remainingCount{0};
+    std::coroutine_handle<> m_continuation{};
+    Clock::time_point       m_runStart{};
+    // Only set during runAndWait(), whose thread runs the main thread nodes from m_mainThreadLane.
+    bool                    m_runningInline{false};
+    Queue<Node *, 64>       m_mainThreadLane;
+    // Bumped whenever a node is added to the lane or the run finishes, so that runAndWait() can sleep on it.
+    std::atomic<uint32_t>   m_laneEpoch{0};
+
+    /** Reset the counts of a new run, then submit the nodes that depend on nothing. */
+    void start();
+
+    Task<void> execute();
+
+    Task<void> executeNode(Node &t_node);
+
+    /** Run t_node's job, then submit every successor that it was the last dependency of. */
+    void runNode(Node &t_node);
+
+    void submitNode(Node &t_node);
+
+    void finishOne();
+};
+}  // namespace IE::Core::Threading
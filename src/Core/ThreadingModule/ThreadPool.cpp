@@ -2,37 +2,63 @@
 
 #include "EnsureThread.hpp"
 #include "ResumeAfter.hpp"
+#include "Tracer.hpp"
 
+#include <algorithm>
 #include <mutex>
 #include <thread>
 
-IE::Core::Threading::ThreadPool::ThreadPool(uint32_t t_threads) {
+IE::Core::Threading::ThreadPool::ThreadPool(uint32_t t_threads, AffinityPolicy t_affinityPolicy) :
+        m_affinityPolicy(t_affinityPolicy) {
+    for (uint32_t i{0}; i < MAX_WORKERS; ++i) m_workerSlots[i].m_threadPool = this;
+    if (m_affinityPolicy != IE_AFFINITY_POLICY_NONE)
+        for (std::size_t i{0}; i < Topology::get().nodes().size(); ++i)
+            m_nodeQueues.push_back(std::make_unique<TaskQueue>());
+    std::lock_guard<std::mutex> lock(m_workersMutex);
     m_workers.reserve(t_threads);
-    for (; t_threads > 0; --t_threads)
-        m_workers.emplace_back([this] { IE::Core::Threading::Worker::start(this); });
+    for (uint32_t i{0}; i < t_threads; ++i) startWorker();
+}
+
+IE::Core::Threading::ThreadPool::ThreadPool(IE::Core::Threading::Schedule t_schedule, uint32_t t_workers) :
+        ThreadPool(0) {
+    m_schedule = std::make_unique<Schedule>(std::move(t_schedule));
+    // No thread ever claims these slots, so the main thread can play their workers.
+    uint32_t workers = std::clamp<uint32_t>(t_workers, 1, MAX_WORKERS);
+    for (uint32_t i{0}; i < workers; ++i) m_workerSlots[i].m_claimed = true;
+    m_workerSlotsInUse = workers;
 }
 
 void IE::Core::Threading::ThreadPool::startMainThreadLoop() {
-    ThreadPool               &pool = *this;
-    std::shared_ptr<BaseTask> task;
-    std::mutex                mutex;
-    pool.mainThreadID = std::this_thread::get_id();
-    while (!pool.m_mainShutdown) {
-        std::unique_lock<std::mutex> lock(mutex);
-        if (!pool.m_mainQueue.pop(task))
-            pool.m_mainWorkAssignedNotifier.wait(lock, [&]() -> bool {
-                return pool.m_mainQueue.pop(task) || pool.m_mainShutdown;
-            });
-        if (pool.m_mainShutdown) break;
-        task->execute();
-        task = nullptr;
+    mainThreadID = std::this_thread::get_id();
+    // The main thread belongs to the application, so only the tracer gets to name it.
+    Tracer::nameThisThread("IE Main");
+    ScratchArena::m_current = &m_mainScratchArena;
+#if defined(IE_THREADING_STATISTICS)
+    ThreadStatistics::m_current = &m_mainStatistics;
+#endif
+    while (!m_mainShutdown) {
+        // Read the epoch before checking the queue so that a submission made after the check wakes this thread.
+        uint32_t                            epoch = m_mainWorkEpoch.load();
+        ThreadStatistics::Clock::time_point start = ThreadStatistics::now();
+        if (runMainThreadTask()) {
+            ThreadStatistics::countTime(&ThreadStatistics::busyNanoseconds, start, ThreadStatistics::now());
+        } else if (!m_mainShutdown) {
+            m_mainWorkEpoch.wait(epoch);
+            ThreadStatistics::count(&ThreadStatistics::wakeups);
+            ThreadStatistics::countTime(&ThreadStatistics::idleNanoseconds, start, ThreadStatistics::now());
+        }
     }
+}
 
-    // Release any unfinished task to the queue, and notify the remaining worker threads of its existence.
-    if (task) {
-        pool.m_queue.push(task);
-        pool.m_workAssignedNotifier.notify_one();
-    }
+uint32_t IE::Core::Threading::ThreadPool::pumpMainThread(std::chrono::steady_clock::duration t_budget) {
+    if (thisThreadType() != IE_THREAD_TYPE_MAIN_THREAD) return 0;
+    m_mainThreadDeadline = std::chrono::steady_clock::now() + t_budget;
+    uint32_t count{0};
+    do {
+        if (!runMainThreadTask()) break;
+        ++count;
+    } while (std::chrono::steady_clock::now() < m_mainThreadDeadline);
+    return count;
 }
 
 std::shared_ptr<IE::Core::Threading::Task<void>>
@@ -44,17 +70,61 @@ std::shared_ptr<IE::Core::Threading::Task<void>> IE::Core::Threading::ThreadPool
   IE::Core::Threading::ThreadType t_threadType,
   std::coroutine_handle<>         t_handle
 ) {
+    return submit(t_threadType, Worker::currentPriority(), t_handle);
+}
+
+std::shared_ptr<IE::Core::Threading::Task<void>> IE::Core::Threading::ThreadPool::submit(
+  IE::Core::Threading::ThreadType   t_threadType,
+  IE::Core::Threading::TaskPriority t_priority,
+  std::coroutine_handle<>           t_handle
+) {
+    // The coroutine checks its own cancellation token when it resumes, so the task that resumes it must not be
+    // cancelled with some other token.
     return prepareAndSubmit(
-      std::make_shared<Task<void>>([](std::coroutine_handle<> handle) -> Task<void> {
-          co_return handle.resume();
-      }(t_handle)),
-      t_threadType
+      allocateTask([](std::coroutine_handle<> handle) -> Task<void> { co_return handle.resume(); }(t_handle)),
+      t_threadType,
+      t_priority,
+      CancellationToken{}
     );
 }
 
+uint32_t IE::Core::Threading::ThreadPool::nextChoice(uint32_t t_choiceCount) {
+    std::lock_guard<std::mutex> lock(m_scheduleMutex);
+    return m_schedule->next(t_choiceCount);
+}
+
+bool IE::Core::Threading::ThreadPool::runScheduled() {
+    uint32_t mainChoices   = m_mainQueue.empty() ? 0 : 1;
+    uint32_t workerChoices = queuedTaskCount() > 0 ? m_workerSlotsInUse.load(std::memory_order_relaxed) : 0;
+    if (mainChoices + workerChoices == 0) return false;
+    uint32_t                  choice = nextChoice(mainChoices + workerChoices);
+    // A worker task may wait for other tasks, so this may be reached while already playing a worker.
+    Worker                   *previousWorker = Worker::m_current;
+    std::shared_ptr<BaseTask> task;
+    bool                      found;
+    if (choice < mainChoices) {
+        Worker::m_current = nullptr;
+        found             = m_mainQueue.pop(task);
+    } else {
+        Worker::m_current = &m_workerSlots[choice - mainChoices];
+        found             = Worker::findTask(*this, task);
+    }
+    if (found) Worker::execute(task);
+    Worker::m_current = previousWorker;
+    return found;
+}
+
+bool IE::Core::Threading::ThreadPool::runMainThreadTask() {
+    if (m_schedule != nullptr) return runScheduled();
+    std::shared_ptr<BaseTask> task;
+    if (!m_mainQueue.pop(task)) return false;
+    Worker::execute(task);
+    return true;
+}
+
 void IE::Core::Threading::ThreadPool::awakenAll() {
-    m_workAssignedNotifier.notify_all();
-    m_mainWorkAssignedNotifier.notify_one();
+    notifyAllWorkers();
+    notifyMainThread();
 }
 
 IE::Core::Threading::EnsureThread
@@ -62,38 +132,221 @@ IE::Core::Threading::ThreadPool::ensureThread(IE::Core::Threading::ThreadType t_
     return {this, t_type};
 }
 
+IE::Core::Threading::Sleep
+IE::Core::Threading::ThreadPool::until(std::chrono::steady_clock::time_point t_deadline) {
+    return {this, thisThreadType(), t_deadline};
+}
+
+IE::Core::Threading::Readable IE::Core::Threading::ThreadPool::readable(int t_fileDescriptor) {
+    return {this, thisThreadType(), t_fileDescriptor};
+}
+
+IE::Core::Threading::Reactor &IE::Core::Threading::ThreadPool::getReactor() {
+    std::call_once(m_reactorStarted, [this] { m_reactor = std::make_unique<Reactor>(this); });
+    return *m_reactor;
+}
+
+IE::Core::Threading::ScratchArenaAccess IE::Core::Threading::ThreadPool::scratch() {
+    return {};
+}
+
+std::vector<IE::Core::Threading::ScratchArena::Statistics>
+IE::Core::Threading::ThreadPool::getScratchStatistics() {
+    std::vector<ScratchArena::Statistics> statistics{m_mainScratchArena.statistics()};
+    uint32_t                              slotsInUse = m_workerSlotsInUse.load(std::memory_order_acquire);
+    for (uint32_t i{0}; i < slotsInUse; ++i) statistics.push_back(m_workerSlots[i].m_scratchArena.statistics());
+    return statistics;
+}
+
+IE::Core::Threading::ThreadPoolStatistics IE::Core::Threading::ThreadPool::getStatistics() {
+    ThreadPoolStatistics statistics{};
+    for (std::size_t i{0}; i < m_queues.size(); ++i) statistics.queueDepths[i] = m_queues[i].size();
+    statistics.mainQueueDepth = m_mainQueue.size();
+    uint32_t slotsInUse       = m_workerSlotsInUse.load(std::memory_order_acquire);
+    for (uint32_t i{0}; i < slotsInUse; ++i) statistics.dequeDepths.push_back(m_workerSlots[i].m_deque.size());
+#if defined(IE_THREADING_STATISTICS)
+    auto addThread = [&statistics](const ThreadStatistics &t_thread) {
+        statistics.threads.push_back(
+          {.busyNanoseconds = t_thread.busyNanoseconds.load(std::memory_order_relaxed),
+           .idleNanoseconds = t_thread.idleNanoseconds.load(std::memory_order_relaxed),
+           .tasksExecuted   = t_thread.tasksExecuted.load(std::memory_order_relaxed),
+           .steals          = t_thread.steals.load(std::memory_order_relaxed),
+           .wakeups         = t_thread.wakeups.load(std::memory_order_relaxed)}
+        );
+        statistics.queueLatency.merge(t_thread.queueLatency);
+        statistics.executionLatency.merge(t_thread.executionLatency);
+    };
+    addThread(m_mainStatistics);
+    for (uint32_t i{0}; i < slotsInUse; ++i) addThread(m_workerSlots[i].m_statistics);
+#endif
+    return statistics;
+}
+
 IE::Core::Threading::ThreadPool::~ThreadPool() {
     shutdown();
-    for (std::thread &thread : m_workers)
+    m_reactor.reset();
+    // Exiting workers take the lock to announce themselves, so they must not be joined while it is held.
+    std::vector<std::thread> workers;
+    {
+        std::lock_guard<std::mutex> lock(m_workersMutex);
+        workers.swap(m_workers);
+    }
+    for (std::thread &thread : workers)
         if (thread.joinable()) thread.join();
+    abandonQueuedTasks();
 }
 
 uint32_t IE::Core::Threading::ThreadPool::getWorkerCount() {
-    return m_workers.size();
+    return m_liveWorkerCount.load();
+}
+
+uint32_t IE::Core::Threading::ThreadPool::getNodeCount() {
+    return m_nodeQueues.size();
 }
 
 void IE::Core::Threading::ThreadPool::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(m_scalerMutex);
+        m_scalerShutdown = true;
+    }
+    m_scalerCondition.notify_all();
+    // The scaler must be gone before the workers are counted, or it could start a worker that takes the shutdown
+    // meant for another, leaving that one running forever.
+    if (m_scaler.joinable()) m_scaler.join();
     m_mainShutdown = true;
-    m_mainWorkAssignedNotifier.notify_one();
-    m_threadShutdownCount = getWorkerCount();
-    m_workAssignedNotifier.notify_all();
+    notifyMainThread();
+    {
+        std::lock_guard<std::mutex> lock(m_workersMutex);
+        m_threadShutdownCount = getWorkerCount();
+    }
+    notifyAllWorkers();
 }
 
 void IE::Core::Threading::ThreadPool::setWorkerCount(uint32_t t_threads) {
-    static std::mutex           mutex;
     // Ensure no other thread is trying to set the worker count. This would result in a deadlock.
-    std::lock_guard<std::mutex> lock(mutex);
+    std::lock_guard<std::mutex> lock(m_workersMutex);
+    if (m_schedule != nullptr || m_mainShutdown) return;
+    reapWorkers();
 
     int64_t threadCountDifference = t_threads - (int64_t) getWorkerCount();
-    if (threadCountDifference == 0) return shutdown();
+    if (threadCountDifference == 0) return;
     if (threadCountDifference < 0) {
         // Shutdown threadCountDifference threads.
         m_threadShutdownCount = std::abs(threadCountDifference);
-        return m_workAssignedNotifier.notify_all();
+        return notifyAllWorkers();
     }
 
     // Add in the number of threads needed to bring the population up to the requested number.
-    m_workers.reserve(t_threads);
-    for (; threadCountDifference > 0; --threadCountDifference)
-        m_workers.emplace_back([this] { IE::Core::Threading::Worker::start(this); });
-}
\ No newline at end of file
+    for (; threadCountDifference > 0; --threadCountDifference) startWorker();
+}
+
+void IE::Core::Threading::ThreadPool::setAdaptiveWorkerCount(uint32_t t_minWorkers, uint32_t t_maxWorkers) {
+    if (m_schedule != nullptr) return;
+    t_minWorkers = std::clamp(t_minWorkers, 1U, MAX_WORKERS);
+    t_maxWorkers = std::clamp(t_maxWorkers, t_minWorkers, MAX_WORKERS);
+    {
+        std::lock_guard<std::mutex> lock(m_scalerMutex);
+        m_minWorkers = t_minWorkers;
+        m_maxWorkers = t_maxWorkers;
+    }
+    setWorkerCount(std::clamp(getWorkerCount(), t_minWorkers, t_maxWorkers));
+    std::call_once(m_scalerStarted, [this] { m_scaler = std::thread([this] { scale(); }); });
+}
+
+void IE::Core::Threading::ThreadPool::startWorker() {
+    // Take the lowest free index, so that a new worker never shares its name or placement with a running one.
+    auto freeIndex = std::find(m_workerIndicesInUse.begin(), m_workerIndicesInUse.end(), false);
+    auto index     = static_cast<uint32_t>(freeIndex - m_workerIndicesInUse.begin());
+    if (freeIndex == m_workerIndicesInUse.end()) m_workerIndicesInUse.push_back(true);
+    else *freeIndex = true;
+    m_liveWorkerCount.fetch_add(1);
+    m_workers.emplace_back([this, index] {
+        IE::Core::Threading::Worker::start(this, index);
+        std::lock_guard<std::mutex> lock(m_workersMutex);
+        m_exitedWorkers.push_back(std::this_thread::get_id());
+        m_workerIndicesInUse[index] = false;
+        m_liveWorkerCount.fetch_sub(1);
+    });
+}
+
+void IE::Core::Threading::ThreadPool::reapWorkers() {
+    // An exited worker only announces itself while holding the lock, so it has already let go of it by now.
+    for (std::thread::id exited : m_exitedWorkers) {
+        auto worker = std::find_if(m_workers.begin(), m_workers.end(), [exited](const std::thread &t_worker) {
+            return t_worker.get_id() == exited;
+        });
+        if (worker == m_workers.end()) continue;
+        worker->join();
+        m_workers.erase(worker);
+    }
+    m_exitedWorkers.clear();
+}
+
+void IE::Core::Threading::ThreadPool::abandonQueuedTasks() {
+    std::shared_ptr<BaseTask> task;
+    for (TaskQueue &queue : m_queues)
+        while (queue.pop(task)) task->abandon();
+    for (const std::unique_ptr<TaskQueue> &queue : m_nodeQueues)
+        while (queue->pop(task)) task->abandon();
+    while (m_mainQueue.pop(task)) task->abandon();
+    // Exiting workers hand their deques over to the shared queues, but a worker slot may still hold a few.
+    uint32_t slotsInUse = m_workerSlotsInUse.load(std::memory_order_acquire);
+    for (uint32_t i{0}; i < slotsInUse; ++i)
+        while (m_workerSlots[i].steal(task)) task->abandon();
+}
+
+std::size_t IE::Core::Threading::ThreadPool::queuedTaskCount() {
+    std::size_t count{0};
+    for (TaskQueue &queue : m_queues) count += queue.size();
+    for (const std::unique_ptr<TaskQueue> &queue : m_nodeQueues) count += queue->size();
+    uint32_t slotsInUse = m_workerSlotsInUse.load(std::memory_order_acquire);
+    for (uint32_t i{0}; i < slotsInUse; ++i) count += m_workerSlots[i].m_deque.size();
+    return count;
+}
+
+void IE::Core::Threading::ThreadPool::scale() {
+    Topology::nameThisThread("IE Scaler");
+    uint32_t                     busyIntervals{0};
+    uint32_t                     idleIntervals{0};
+    std::unique_lock<std::mutex> lock(m_scalerMutex);
+    while (!m_scalerCondition.wait_for(lock, SCALING_INTERVAL, [this] { return m_scalerShutdown.load(); })) {
+        uint32_t minWorkers = m_minWorkers;
+        uint32_t maxWorkers = m_maxWorkers;
+        lock.unlock();
+        {
+            std::lock_guard<std::mutex> workersLock(m_workersMutex);
+            // Shutting down counts the workers under this lock, so none may be started or retired after that.
+            if (m_scalerShutdown) return;
+            reapWorkers();
+            // Workers that have been told to shut down, but have not yet, no longer count.
+            uint32_t    workers = getWorkerCount() - std::min(getWorkerCount(), m_threadShutdownCount.load());
+            std::size_t backlog = queuedTaskCount();
+            bool        idle    = m_sleepingWorkers.load() > 0 && backlog == 0;
+            bool        busy    = !idle && backlog > SCALING_BACKLOG_PER_WORKER * std::max(workers, 1U);
+            busyIntervals       = busy ? busyIntervals + 1 : 0;
+            idleIntervals       = idle ? idleIntervals + 1 : 0;
+            if (workers < minWorkers || (busyIntervals >= SCALING_GROW_INTERVALS && workers < maxWorkers)) {
+                // Add enough workers to bring the backlog per worker back down in one go.
+                std::size_t wanted = std::max<std::size_t>(backlog / SCALING_BACKLOG_PER_WORKER, minWorkers);
+                for (std::size_t i = workers; i < std::clamp<std::size_t>(wanted, workers + 1, maxWorkers); ++i)
+                    startWorker();
+                busyIntervals = 0;
+            } else if (idleIntervals >= SCALING_RETIRE_INTERVALS && workers > minWorkers) {
+                // Keep retiring one worker per interval for as long as the pool stays idle.
+                ++m_threadShutdownCount;
+                notifyAllWorkers();
+            }
+        }
+        lock.lock();
+    }
+}
+
+bool IE::Core::Threading::ThreadPool::deterministic() const {
+    return m_schedule != nullptr;
+}
+
+bool IE::Core::Threading::ThreadPool::saveSchedule(const std::filesystem::path &t_path) {
+    if (m_schedule == nullptr) return false;
+    std::lock_guard<std::mutex> lock(m_scheduleMutex);
+    return m_schedule->save(t_path);
+}
@@ -1,10 +1,19 @@
 #pragma once
 
+#include "Allocator.hpp"
 #include "Core/ThreadingModule/Awaitable.hpp"
 #include "EnsureThread.hpp"
 #include "Queue.hpp"
+#include "Reactor.hpp"
+#include "Readable.hpp"
 #include "ResumeAfter.hpp"
+#include "Schedule.hpp"
+#include "ScratchArena.hpp"
+#include "Sleep.hpp"
+#include "Statistics.hpp"
 #include "Task.hpp"
+#include "Topology.hpp"
+#include "WhenAll.hpp"
 #include "Worker.hpp"
 
 #include <memory>
@@ -20,38 +29,323 @@ using std::experimental::suspend_never;
 #else
 #    include <coroutine>
 #endif
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <functional>
+#include <iterator>
+#include <mutex>
+#include <ranges>
+#include <span>
 #include <thread>
+#include <vector>
 
-/**@todo Enable waiting on non-thread pool related things. (e.g. sleep(1))*/
 namespace IE::Core::Threading {
+/** A contiguous range of tasks that have not been submitted yet, such as a std::vector<Task<T>>. */
+template<typename R>
+concept TaskRange = std::ranges::contiguous_range<R> && std::ranges::sized_range<R> &&
+  requires { typename std::ranges::range_value_t<R>::ReturnType; } &&
+  std::same_as<std::ranges::range_value_t<R>, Task<typename std::ranges::range_value_t<R>::ReturnType>>;
+
+/** The type of the tasks that submitting the range R returns. */
+template<TaskRange R>
+using TaskRangeResult = std::vector<std::shared_ptr<std::ranges::range_value_t<R>>>;
+
 class ThreadPool {
-    std::vector<std::thread>         m_workers;
-    Queue<std::shared_ptr<BaseTask>> m_queue;
-    Queue<std::shared_ptr<BaseTask>> m_mainQueue;
-    std::condition_variable_any      m_workAssignedNotifier;
-    std::condition_variable_any      m_mainWorkAssignedNotifier;
-    std::atomic<bool>                m_mainShutdown{false};
-    std::thread::id                  mainThreadID;
-    std::atomic<uint32_t>            m_threadShutdownCount{0};
+public:
+    /// The maximum number of workers that get a work-stealing deque of their own.
+    static constexpr uint32_t MAX_WORKERS{256};
+    /// How often a pool with an adaptive worker count reconsiders how many workers it needs.
+    static constexpr std::chrono::milliseconds SCALING_INTERVAL{50};
+    /// The number of queued tasks per worker above which an adaptive pool starts adding workers.
+    static constexpr uint32_t                  SCALING_BACKLOG_PER_WORKER{4};
+    /// The number of intervals that the backlog must stay above that before workers are added.
+    static constexpr uint32_t                  SCALING_GROW_INTERVALS{2};
+    /// The number of intervals that workers must stay idle before an adaptive pool starts retiring them.
+    static constexpr uint32_t                  SCALING_RETIRE_INTERVALS{40};
+
+private:
+    using TaskQueue = Queue<std::shared_ptr<BaseTask>>;
+
+    // Guards m_workers, m_exitedWorkers and m_workerIndicesInUse.
+    std::mutex                                      m_workersMutex;
+    std::vector<std::thread>                        m_workers;
+    // Workers that have returned, but have not been joined yet.
+    std::vector<std::thread::id>                    m_exitedWorkers;
+    // Which worker indices belong to a running worker. An index is only handed out again once its worker returns.
+    std::vector<bool>                               m_workerIndicesInUse;
+    std::atomic<uint32_t>                           m_liveWorkerCount{0};
+    // One queue of worker thread work for each TaskPriority.
+    std::array<Queue<std::shared_ptr<BaseTask>>, 3> m_queues;
+    Queue<std::shared_ptr<BaseTask>>                m_mainQueue;
+    // Event counts that idle threads park on. They are bumped every time work is published.
+    std::atomic<uint32_t>                           m_workEpoch{0};
+    std::atomic<uint32_t>                           m_mainWorkEpoch{0};
+    std::atomic<uint32_t>                           m_sleepingWorkers{0};
+    // Workers that are blocked in Worker::waitForTask() until the task that they wait for finishes.
+    std::atomic<uint32_t>                           m_waitingWorkers{0};
+    // Set while the main thread waits for a task, so that workers wake it up as they run out of work.
+    std::atomic<bool>                               m_mainThreadWaiting{false};
+    // The end of the budget that pumpMainThread() was last given. Only used by the main thread.
+    std::chrono::steady_clock::time_point           m_mainThreadDeadline{};
+    std::atomic<bool>                               m_mainShutdown{false};
+    std::thread::id                                 mainThreadID;
+    std::atomic<uint32_t>                           m_threadShutdownCount{0};
+    std::unique_ptr<Worker[]>                       m_workerSlots{std::make_unique<Worker[]>(MAX_WORKERS)};
+    std::atomic<uint32_t>                           m_workerSlotsInUse{0};
+    AffinityPolicy                                  m_affinityPolicy;
+    // One queue per NUMA node for work that should stay on that node. Empty when workers are not bound to nodes.
+    std::vector<std::unique_ptr<TaskQueue>>         m_nodeQueues;
+    // Started the first time that a coroutine waits on a timer or file descriptor.
+    std::unique_ptr<Reactor>                        m_reactor;
+    std::once_flag                                  m_reactorStarted;
+    ScratchArena                                    m_mainScratchArena;
+    // Only set for a deterministic pool, whose workers are all played by its main thread.
+    std::unique_ptr<Schedule>                       m_schedule;
+    std::mutex                                      m_scheduleMutex;
+    // Only started for a pool with an adaptive worker count. The bounds are guarded by m_scalerMutex.
+    std::thread                                     m_scaler;
+    std::once_flag                                  m_scalerStarted;
+    std::mutex                                      m_scalerMutex;
+    std::condition_variable                         m_scalerCondition;
+    // Also read by the scaler under m_workersMutex, so it is atomic.
+    std::atomic<bool>                               m_scalerShutdown{false};
+    uint32_t                                        m_minWorkers{0};
+    uint32_t                                        m_maxWorkers{0};
+#if defined(IE_THREADING_STATISTICS)
+    ThreadStatistics m_mainStatistics;
+#endif
+
+    /** Allocate a task from the per-thread task pool. It shares its block with the shared_ptr control block. */
+    template<typename T>
+    static std::shared_ptr<Task<T>> allocateTask(Task<T> t_task) {
+        return std::allocate_shared<Task<T>>(PoolAllocator<Task<T>>{}, t_task);
+    }
 
     template<typename T>
     std::shared_ptr<Task<T>>
-    prepareAndSubmit(std::shared_ptr<Task<T>> t_task, ThreadType t_threadType = IE_THREAD_TYPE_WORKER_THREAD) {
-        t_task->connectHandle();
-        bool worker = t_threadType == IE_THREAD_TYPE_WORKER_THREAD;
-        (worker ? m_queue : m_mainQueue).push(std::static_pointer_cast<BaseTask>(t_task));
-        (worker ? m_workAssignedNotifier : m_mainWorkAssignedNotifier).notify_one();
+    prepareAndSubmit(
+      std::shared_ptr<Task<T>> t_task,
+      ThreadType               t_threadType,
+      TaskPriority             t_priority,
+      CancellationToken        t_cancellationToken = Worker::currentCancellationToken()
+    ) {
+        Task<T>::connectHandle(t_task);
+        t_task->m_priority          = t_priority;
+        t_task->m_cancellationToken = std::move(t_cancellationToken);
+        ThreadStatistics::taskSubmitted(*t_task);
+        if (t_threadType == IE_THREAD_TYPE_MAIN_THREAD) {
+            m_mainQueue.push(std::static_pointer_cast<BaseTask>(t_task));
+            notifyMainThread();
+            return t_task;
+        }
+        // Normal work submitted from one of this pool's workers stays on that worker's deque unless it is stolen.
+        // Everything else goes to the shared queue for its priority so that every worker sees it in order.
+        Worker *worker = Worker::current();
+        if (t_priority == IE_TASK_PRIORITY_NORMAL && worker != nullptr && worker->m_threadPool == this)
+            worker->push(std::static_pointer_cast<BaseTask>(t_task));
+        else m_queues[t_priority].push(std::static_pointer_cast<BaseTask>(t_task));
+        notifyWorker();
         return t_task;
     }
 
+    template<typename T>
+    std::vector<std::shared_ptr<Task<T>>> prepareAndSubmitBatch(
+      std::span<const Task<T>> t_coroutines,
+      ThreadType               t_threadType,
+      TaskPriority             t_priority
+    ) {
+        std::vector<std::shared_ptr<Task<T>>>  tasks;
+        std::vector<std::shared_ptr<BaseTask>> published;
+        tasks.reserve(t_coroutines.size());
+        published.reserve(t_coroutines.size());
+        CancellationToken cancellationToken = Worker::currentCancellationToken();
+        for (const Task<T> &coroutine : t_coroutines) {
+            std::shared_ptr<Task<T>> task = allocateTask(coroutine);
+            Task<T>::connectHandle(task);
+            task->m_priority          = t_priority;
+            task->m_cancellationToken = cancellationToken;
+            ThreadStatistics::taskSubmitted(*task);
+            tasks.push_back(task);
+            published.push_back(std::move(task));
+        }
+        if (t_threadType == IE_THREAD_TYPE_MAIN_THREAD) {
+            m_mainQueue.push(published.begin(), published.end());
+            notifyMainThread();
+            return tasks;
+        }
+        // The same routing as prepareAndSubmit(), but each queue is only touched once for the whole batch.
+        Worker *worker = Worker::current();
+        if (t_priority == IE_TASK_PRIORITY_NORMAL && worker != nullptr && worker->m_threadPool == this)
+            for (std::shared_ptr<BaseTask> &task : published) worker->push(std::move(task));
+        else m_queues[t_priority].push(published.begin(), published.end());
+        notifyWorkers(published.size());
+        return tasks;
+    }
+
+    /** @return A read-only view of the tasks in t_coroutines, whatever kind of contiguous range it is. */
+    template<TaskRange R>
+    static std::span<const std::ranges::range_value_t<R>> viewTasks(R &t_coroutines) {
+        return {std::ranges::data(t_coroutines), std::ranges::size(t_coroutines)};
+    }
+
+    template<typename T>
+    std::shared_ptr<Task<T>> prepareAndSubmitToNode(std::shared_ptr<Task<T>> t_task, uint32_t t_node) {
+        // A deterministic pool has no node queues either.
+        if (t_node >= m_nodeQueues.size())
+            return prepareAndSubmit(t_task, IE_THREAD_TYPE_WORKER_THREAD, Worker::currentPriority());
+        Task<T>::connectHandle(t_task);
+        t_task->m_priority          = Worker::currentPriority();
+        t_task->m_cancellationToken = Worker::currentCancellationToken();
+        ThreadStatistics::taskSubmitted(*t_task);
+        m_nodeQueues[t_node]->push(std::static_pointer_cast<BaseTask>(t_task));
+        notifyWorker();
+        return t_task;
+    }
+
+    /** Wake exactly one parked worker, if there are any, to pick up newly published work. */
+    void notifyWorker() {
+        m_workEpoch.fetch_add(1);
+        if (m_sleepingWorkers.load() > 0) m_workEpoch.notify_one();
+        if (m_schedule != nullptr) notifyMainThread();
+    }
+
+    /** Wake as many parked workers as there are new tasks, up to all of them. */
+    void notifyWorkers(std::size_t t_count) {
+        m_workEpoch.fetch_add(1);
+        if (m_schedule != nullptr) notifyMainThread();
+        uint32_t sleepingWorkers = m_sleepingWorkers.load();
+        if (sleepingWorkers == 0) return;
+        if (t_count >= sleepingWorkers) return m_workEpoch.notify_all();
+        for (std::size_t i{0}; i < t_count; ++i) m_workEpoch.notify_one();
+    }
+
+    void notifyAllWorkers() {
+        m_workEpoch.fetch_add(1);
+        m_workEpoch.notify_all();
+    }
+
+    void notifyMainThread() {
+        m_mainWorkEpoch.fetch_add(1);
+        m_mainWorkEpoch.notify_one();
+    }
+
+    /** Called by a worker that runs out of work, in case the main thread is waiting for all of them to do so. */
+    void notifyWaitingMainThread() {
+        if (m_mainThreadWaiting.load()) notifyMainThread();
+    }
+
+    /**
+     * @return True if the main thread may run other main thread work while it waits for a task. It may while some
+     * of the budget of the last pumpMainThread() is left, and after that only once every worker has run out of
+     * work, as the task it waits for can then only be held up by main thread work.
+     */
+    bool mainThreadWorkAllowed() {
+        return std::chrono::steady_clock::now() < m_mainThreadDeadline ||
+               (m_sleepingWorkers.load() + m_waitingWorkers.load() >= getWorkerCount() && queuedTaskCount() == 0);
+    }
+
+    /** Start one more worker. m_workersMutex must be held. */
+    void startWorker();
+
+    /** Join and forget the workers that have returned. m_workersMutex must be held. */
+    void reapWorkers();
+
+    /** Abandon every task that is still queued. Only called once no thread can take them any more. */
+    void abandonQueuedTasks();
+
+    /** @return The number of tasks waiting in the worker queues and deques. */
+    std::size_t queuedTaskCount();
+
+    /** The loop of the thread that adapts the worker count. */
+    void scale();
+
+    /** @return The next choice of a deterministic pool's schedule, out of t_choiceCount. */
+    uint32_t nextChoice(uint32_t t_choiceCount);
+
+    /**
+     * @brief Run one task on the main thread of a deterministic pool.
+     * @details The schedule picks either the main thread, if it has a task queued, or one of the workers, if any
+     * worker task is queued. A picked worker is played by the main thread, and takes its task from the queues and
+     * deques just like a worker thread would, stealing from the other workers if it has to.
+     * @return False if no task was queued.
+     */
+    bool runScheduled();
+
+    /** Run one task that the main thread may take. @return False if there was none. */
+    bool runMainThreadTask();
+
+    /**
+     * @brief Decide whether a parallel algorithm should split off more of its range.
+     * @details Ranges are split lazily. A worker only hands out more work once everything that it previously split
+     * off has been taken by other threads, so idle workers get fed quickly without flooding a busy pool with
+     * tasks.
+     */
+    bool shouldSplit() {
+        Worker *worker = Worker::current();
+        return worker == nullptr || worker->m_threadPool != this || worker->m_deque.empty();
+    }
+
+    std::size_t defaultGrainSize(std::size_t t_count) {
+        return std::max<std::size_t>(1, t_count / (8 * (getWorkerCount() + 1)));
+    }
+
+    /*
+     * The outermost task of a parallel algorithm owns the functions that it was given. Every task that it splits
+     * off is instantiated with references to them instead, which stay valid because a task always waits for the
+     * tasks that it split off before finishing.
+     */
+    template<typename F>
+    Task<void> parallelForRange(std::size_t t_begin, std::size_t t_end, std::size_t t_grainSize, F t_function);
+
+    template<typename T, typename Map, typename Reduce>
+    Task<T> parallelReduceRange(
+      std::size_t t_begin,
+      std::size_t t_end,
+      std::size_t t_grainSize,
+      T           t_identity,
+      Map         t_map,
+      Reduce      t_reduce
+    );
+
+    template<typename Iterator, typename Compare>
+    Task<void> parallelSortRange(Iterator t_first, Iterator t_last, std::size_t t_grainSize, Compare t_compare);
+
 public:
-    explicit ThreadPool(uint32_t t_threads = std::thread::hardware_concurrency());
+    explicit ThreadPool(
+      uint32_t       t_threads        = std::thread::hardware_concurrency(),
+      AffinityPolicy t_affinityPolicy = IE_AFFINITY_POLICY_NONE
+    );
+
+    /**
+     * @brief Create a deterministic pool, which runs every task on the thread that runs the main thread loop.
+     * @details A deterministic pool never starts any workers. Instead, its main thread plays t_workers workers in
+     * turns picked by t_schedule, so a run can be repeated exactly by replaying its schedule. Tasks are still
+     * routed through the same queues and deques as in any other pool, and the schedule also picks which worker a
+     * steal starts at. Timers and file descriptors are still waited on in real time, so runs that use them can
+     * only be repeated if they finish in the same order.
+     */
+    explicit ThreadPool(Schedule t_schedule, uint32_t t_workers = 4);
 
     void startMainThreadLoop();
 
+    /**
+     * @brief Run waiting main thread work until there is none left or t_budget has passed.
+     * @details Lets a long-running main thread task, such as the game loop, interleave other main thread work with
+     * its own. Work still waiting when the budget runs out is left for the next call. At least one task is run if
+     * any is waiting, so that the main thread's work always makes progress. Until the budget runs out, the main
+     * thread also runs other main thread work while it waits for a task with Worker::waitForTask(). After that, it
+     * only does so once the workers have run out of work. Does nothing unless called from the main thread.
+     * @return The number of tasks that were run.
+     */
+    uint32_t pumpMainThread(std::chrono::steady_clock::duration t_budget);
+
+    /*
+     * Work submitted without an explicit priority inherits the priority of the task that submits it. Work
+     * submitted with an explicit priority always goes to the worker threads.
+     */
     template<typename T>
     std::shared_ptr<Task<T>> submit(Task<T> t_coroutine) {
         return submit(thisThreadType(), t_coroutine);
@@ -59,7 +353,32 @@ public:
 
     template<typename T>
     std::shared_ptr<Task<T>> submit(ThreadType t_threadType, Task<T> t_coroutine) {
-        return prepareAndSubmit(std::make_shared<Task<T>>(t_coroutine), t_threadType);
+        return prepareAndSubmit(allocateTask(t_coroutine), t_threadType, Worker::currentPriority());
+    }
+
+    template<typename T>
+    std::shared_ptr<Task<T>> submit(TaskPriority t_priority, Task<T> t_coroutine) {
+        return prepareAndSubmit(allocateTask(t_coroutine), IE_THREAD_TYPE_WORKER_THREAD, t_priority);
+    }
+
+    template<typename T>
+    std::shared_ptr<Task<T>> submit(ThreadType t_threadType, TaskPriority t_priority, Task<T> t_coroutine) {
+        return prepareAndSubmit(allocateTask(t_coroutine), t_threadType, t_priority);
+    }
+
+    template<typename T>
+    std::shared_ptr<Task<T>> submit(const CancellationToken &t_cancellationToken, Task<T> t_coroutine) {
+        return submit(t_cancellationToken, thisThreadType(), Worker::currentPriority(), t_coroutine);
+    }
+
+    template<typename T>
+    std::shared_ptr<Task<T>> submit(
+      const CancellationToken &t_cancellationToken,
+      ThreadType               t_threadType,
+      TaskPriority             t_priority,
+      Task<T>                  t_coroutine
+    ) {
+        return prepareAndSubmit(allocateTask(t_coroutine), t_threadType, t_priority, t_cancellationToken);
     }
 
     template<typename T, typename... Args>
@@ -71,10 +390,26 @@ public:
     template<typename T, typename... Args>
         requires requires(T &&t_coroutine, Args &&...args) { typename decltype(t_coroutine(args...))::ReturnType; }
     auto submit(ThreadType t_threadType, T &&t_coroutine, Args &&...args)
+      -> std::shared_ptr<Task<typename decltype(t_coroutine(args...))::ReturnType>> {
+        return prepareAndSubmit(allocateTask(t_coroutine(args...)), t_threadType, Worker::currentPriority());
+    }
+
+    template<typename T, typename... Args>
+        requires requires(T &&t_coroutine, Args &&...args) { typename decltype(t_coroutine(args...))::ReturnType; }
+    auto submit(TaskPriority t_priority, T &&t_coroutine, Args &&...args)
+      -> std::shared_ptr<Task<typename decltype(t_coroutine(args...))::ReturnType>> {
+        return prepareAndSubmit(allocateTask(t_coroutine(args...)), IE_THREAD_TYPE_WORKER_THREAD, t_priority);
+    }
+
+    template<typename T, typename... Args>
+        requires requires(T &&t_coroutine, Args &&...args) { typename decltype(t_coroutine(args...))::ReturnType; }
+    auto submit(const CancellationToken &t_cancellationToken, T &&t_coroutine, Args &&...args)
       -> std::shared_ptr<Task<typename decltype(t_coroutine(args...))::ReturnType>> {
         return prepareAndSubmit(
-          std::make_shared<Task<typename decltype(t_coroutine(args...))::ReturnType>>(t_coroutine(args...)),
-          t_threadType
+          allocateTask(t_coroutine(args...)),
+          thisThreadType(),
+          Worker::currentPriority(),
+          t_cancellationToken
         );
     }
 
@@ -87,12 +422,76 @@ public:
     auto submit(ThreadType t_threadType, T &&t_function, Args &&...args)
       -> std::shared_ptr<Task<decltype(t_function(args...))>> {
         return prepareAndSubmit(
-          std::make_shared<Task<decltype(t_function(args...))>>(
-            [](T &&function, Args &&...args) -> Task<decltype(t_function(args...))> {
-                co_return function(args...);
-            }(t_function, args...)
-          ),
-          t_threadType
+          allocateTask([](T &&function, Args &&...args) -> Task<decltype(t_function(args...))> {
+              co_return function(args...);
+          }(t_function, args...)),
+          t_threadType,
+          Worker::currentPriority()
+        );
+    }
+
+    template<typename T, typename... Args>
+    auto submit(TaskPriority t_priority, T &&t_function, Args &&...args)
+      -> std::shared_ptr<Task<decltype(t_function(args...))>> {
+        return prepareAndSubmit(
+          allocateTask([](T &&function, Args &&...args) -> Task<decltype(t_function(args...))> {
+              co_return function(args...);
+          }(t_function, args...)),
+          IE_THREAD_TYPE_WORKER_THREAD,
+          t_priority
+        );
+    }
+
+    /*
+     * Submit many tasks at once. Each queue involved is only synchronized with once for the whole batch, and only
+     * as many workers are woken as there are tasks. The tasks are returned in the same order. Any contiguous range
+     * of Task<T> can be submitted, such as a std::vector, a std::array or a std::span.
+     */
+    template<TaskRange R>
+    TaskRangeResult<R> submitBatch(R &&t_coroutines) {
+        return submitBatch(thisThreadType(), t_coroutines);
+    }
+
+    template<TaskRange R>
+    TaskRangeResult<R> submitBatch(ThreadType t_threadType, R &&t_coroutines) {
+        return prepareAndSubmitBatch(viewTasks(t_coroutines), t_threadType, Worker::currentPriority());
+    }
+
+    template<TaskRange R>
+    TaskRangeResult<R> submitBatch(TaskPriority t_priority, R &&t_coroutines) {
+        return prepareAndSubmitBatch(viewTasks(t_coroutines), IE_THREAD_TYPE_WORKER_THREAD, t_priority);
+    }
+
+    template<TaskRange R>
+    TaskRangeResult<R> submitBatch(ThreadType t_threadType, TaskPriority t_priority, R &&t_coroutines) {
+        return prepareAndSubmitBatch(viewTasks(t_coroutines), t_threadType, t_priority);
+    }
+
+    /*
+     * Submit work to the workers bound to NUMA node t_node, so that it stays close to memory allocated there.
+     * Workers of other nodes only take it when they have nothing else to do. If workers are not bound to nodes,
+     * this is the same as submitting to the worker threads.
+     */
+    template<typename T>
+    std::shared_ptr<Task<T>> submitToNode(uint32_t t_node, Task<T> t_coroutine) {
+        return prepareAndSubmitToNode(allocateTask(t_coroutine), t_node);
+    }
+
+    template<typename T, typename... Args>
+        requires requires(T &&t_coroutine, Args &&...args) { typename decltype(t_coroutine(args...))::ReturnType; }
+    auto submitToNode(uint32_t t_node, T &&t_coroutine, Args &&...args)
+      -> std::shared_ptr<Task<typename decltype(t_coroutine(args...))::ReturnType>> {
+        return prepareAndSubmitToNode(allocateTask(t_coroutine(args...)), t_node);
+    }
+
+    template<typename T, typename... Args>
+    auto submitToNode(uint32_t t_node, T &&t_function, Args &&...args)
+      -> std::shared_ptr<Task<decltype(t_function(args...))>> {
+        return prepareAndSubmitToNode(
+          allocateTask([](T &&function, Args &&...args) -> Task<decltype(t_function(args...))> {
+              co_return function(args...);
+          }(t_function, args...)),
+          t_node
         );
     }
 
@@ -100,6 +499,9 @@ public:
 
     std::shared_ptr<Task<void>> submit(ThreadType t_threadType, std::coroutine_handle<> t_handle);
 
+    std::shared_ptr<Task<void>>
+    submit(ThreadType t_threadType, TaskPriority t_priority, std::coroutine_handle<> t_handle);
+
     template<typename T>
     T executeInPlace(Task<T> t_coroutine) {
         auto coroutine{submit(t_coroutine)};
@@ -116,6 +518,36 @@ public:
         return coroutine->value();
     }
 
+    /**
+     * @brief Call t_function(i) for every i in [t_begin, t_end) on the worker threads.
+     * @details The range is split adaptively, never into pieces smaller than t_grainSize. A grain size of 0 picks
+     * one based on the number of workers. The returned task finishes once every call has returned. Await it with
+     * resumeAfter() from a coroutine, or block on it with Worker::waitForTask().
+     */
+    template<typename F>
+    std::shared_ptr<Task<void>>
+    parallelFor(std::size_t t_begin, std::size_t t_end, std::size_t t_grainSize, F t_function);
+
+    /**
+     * @brief Combine t_map(i) for every i in [t_begin, t_end) using t_reduce on the worker threads.
+     * @details t_reduce must be associative, and t_identity must be its identity. Partial results are combined in
+     * index order, so t_reduce does not need to be commutative.
+     */
+    template<typename T, typename Map, typename Reduce>
+    std::shared_ptr<Task<T>> parallelReduce(
+      std::size_t t_begin,
+      std::size_t t_end,
+      std::size_t t_grainSize,
+      T           t_identity,
+      Map         t_map,
+      Reduce      t_reduce
+    );
+
+    /** Sort [t_first, t_last) on the worker threads. The sort is not stable. */
+    template<typename Iterator, typename Compare = std::less<>>
+    std::shared_ptr<Task<void>>
+    parallelSort(Iterator t_first, Iterator t_last, std::size_t t_grainSize = 0, Compare t_compare = {});
+
     void awakenAll();
 
     template<typename... Args>
@@ -128,9 +560,68 @@ public:
         return ResumeAfter{this, thisThreadType(), args...};
     }
 
+    /** Resume the awaiting coroutine once all of t_tasks have finished, with a tuple of their results. */
+    template<typename... T>
+    WhenAll<T...> whenAll(ThreadType t_threadType, std::shared_ptr<Task<T>>... t_tasks) {
+        return WhenAll<T...>{this, t_threadType, std::move(t_tasks)...};
+    }
+
+    template<typename... T>
+    WhenAll<T...> whenAll(std::shared_ptr<Task<T>>... t_tasks) {
+        return WhenAll<T...>{this, thisThreadType(), std::move(t_tasks)...};
+    }
+
+    /** Resume the awaiting coroutine once all of t_tasks have finished, with a vector of their results. */
+    template<typename T>
+    WhenAllOf<T> whenAll(ThreadType t_threadType, std::vector<std::shared_ptr<Task<T>>> t_tasks) {
+        return WhenAllOf<T>{this, t_threadType, std::move(t_tasks)};
+    }
+
+    template<typename T>
+    WhenAllOf<T> whenAll(std::vector<std::shared_ptr<Task<T>>> t_tasks) {
+        return WhenAllOf<T>{this, thisThreadType(), std::move(t_tasks)};
+    }
+
     EnsureThread ensureThread(ThreadType t_type);
 
+    /** Suspend the awaiting coroutine for at least t_duration. */
+    template<typename Rep, typename Period>
+    Sleep sleepFor(std::chrono::duration<Rep, Period> t_duration) {
+        return until(
+          std::chrono::steady_clock::now() + std::chrono::ceil<std::chrono::steady_clock::duration>(t_duration)
+        );
+    }
+
+    /** Suspend the awaiting coroutine until t_deadline has passed. */
+    Sleep until(std::chrono::steady_clock::time_point t_deadline);
+
+    /** Suspend the awaiting coroutine until t_fileDescriptor can be read from. */
+    Readable readable(int t_fileDescriptor);
+
+    Reactor &getReactor();
+
+    /**
+     * @brief Get the scratch arena of the thread that the awaiting coroutine is running on, with co_await.
+     * @details Memory from it is freed once the task returns, and must not be used across a later co_await. The
+     * same arena is available outside of coroutines from ScratchArena::current().
+     */
+    ScratchArenaAccess scratch();
+
+    /** @return Statistics for the main thread's scratch arena, followed by those of each worker slot in use. */
+    std::vector<ScratchArena::Statistics> getScratchStatistics();
+
+    /**
+     * @brief Take a snapshot of the pool's statistics.
+     * @details Queue depths are always sampled. Everything else is only collected when the engine is built with
+     * IE_THREADING_STATISTICS.
+     */
+    ThreadPoolStatistics getStatistics();
+
     ThreadType thisThreadType() {
+        // The workers of a deterministic pool are played by its main thread.
+        Worker *worker = Worker::current();
+        if (m_schedule != nullptr && worker != nullptr && worker->m_threadPool == this)
+            return IE_THREAD_TYPE_WORKER_THREAD;
         return std::this_thread::get_id() == mainThreadID ? IE_THREAD_TYPE_MAIN_THREAD :
                                                             IE_THREAD_TYPE_WORKER_THREAD;
     }
@@ -139,13 +630,174 @@ public:
 
     uint32_t getWorkerCount();
 
+    /** @return The number of NUMA nodes that workers are bound to, or 0 if they are not bound to nodes. */
+    uint32_t getNodeCount();
+
     void shutdown();
 
     void setWorkerCount(uint32_t t_threads = std::thread::hardware_concurrency());
 
-    friend void Worker::start(ThreadPool *t_threadPool);
-    friend void Worker::waitForTask(ThreadPool *t_threadPool, BaseTask &t_task);
+    /**
+     * @brief Let the pool pick its own number of workers, between t_minWorkers and t_maxWorkers.
+     * @details Workers are added while the queued work keeps outgrowing the workers that there are, and retired
+     * one at a time once some of them have been idle for a while, so that an idle engine does not keep threads
+     * around that it has no use for. An explicit call to setWorkerCount() still takes effect, until the pool next
+     * decides to adapt. Both bounds are clamped to between 1 and MAX_WORKERS. Does nothing for a deterministic
+     * pool.
+     */
+    void
+    setAdaptiveWorkerCount(uint32_t t_minWorkers, uint32_t t_maxWorkers = std::thread::hardware_concurrency());
+
+    [[nodiscard]] bool deterministic() const;
 
-    friend bool EnsureThread::await_ready();
+    /**
+     * @brief Save every choice that this deterministic pool's schedule has made so far, to replay them later.
+     * @return False if the pool is not deterministic or if the file could not be written.
+     */
+    bool saveSchedule(const std::filesystem::path &t_path);
+
+    friend class Worker;
 };
+
+template<typename F>
+std::shared_ptr<Task<void>>
+ThreadPool::parallelFor(std::size_t t_begin, std::size_t t_end, std::size_t t_grainSize, F t_function) {
+    // An empty range still returns a task, but one that has nothing to do.
+    if (t_begin >= t_end) t_end = t_begin;
+    if (t_grainSize == 0) t_grainSize = defaultGrainSize(t_end - t_begin);
+    return submit(
+      IE_THREAD_TYPE_WORKER_THREAD,
+      parallelForRange<F>(t_begin, t_end, t_grainSize, std::move(t_function))
+    );
+}
+
+template<typename T, typename Map, typename Reduce>
+std::shared_ptr<Task<T>> ThreadPool::parallelReduce(
+  std::size_t t_begin,
+  std::size_t t_end,
+  std::size_t t_grainSize,
+  T           t_identity,
+  Map         t_map,
+  Reduce      t_reduce
+) {
+    // An empty range reduces to t_identity.
+    if (t_begin >= t_end) t_end = t_begin;
+    if (t_grainSize == 0) t_grainSize = defaultGrainSize(t_end - t_begin);
+    return submit(
+      IE_THREAD_TYPE_WORKER_THREAD,
+      parallelReduceRange<T, Map, Reduce>(
+        t_begin,
+        t_end,
+        t_grainSize,
+        std::move(t_identity),
+        std::move(t_map),
+        std::move(t_reduce)
+      )
+    );
+}
+
+template<typename Iterator, typename Compare>
+std::shared_ptr<Task<void>>
+ThreadPool::parallelSort(Iterator t_first, Iterator t_last, std::size_t t_grainSize, Compare t_compare) {
+    if (t_grainSize == 0) t_grainSize = defaultGrainSize(t_last - t_first);
+    return submit(
+      IE_THREAD_TYPE_WORKER_THREAD,
+      parallelSortRange<Iterator, Compare>(t_first, t_last, t_grainSize, std::move(t_compare))
+    );
+}
+
+template<typename F>
+Task<void>
+ThreadPool::parallelForRange(std::size_t t_begin, std::size_t t_end, std::size_t t_grainSize, F t_function) {
+    std::vector<std::shared_ptr<BaseTask>> splits;
+    while (t_begin < t_end) {
+        if (t_end - t_begin > t_grainSize && shouldSplit()) {
+            // Hand the upper half of what is left to whichever worker wants it.
+            std::size_t middle = t_begin + (t_end - t_begin) / 2;
+            splits.push_back(submit(
+              IE_THREAD_TYPE_WORKER_THREAD,
+              parallelForRange<std::remove_reference_t<F> &>(middle, t_end, t_grainSize, t_function)
+            ));
+            t_end = middle;
+        } else
+            for (std::size_t end = std::min(t_end, t_begin + t_grainSize); t_begin < end; ++t_begin)
+                t_function(t_begin);
+    }
+    co_await resumeAfter(IE_THREAD_TYPE_WORKER_THREAD, splits);
+}
+
+template<typename T, typename Map, typename Reduce>
+Task<T> ThreadPool::parallelReduceRange(
+  std::size_t t_begin,
+  std::size_t t_end,
+  std::size_t t_grainSize,
+  T           t_identity,
+  Map         t_map,
+  Reduce      t_reduce
+) {
+    std::vector<std::shared_ptr<Task<T>>> splits;
+    T                                     result{t_identity};
+    while (t_begin < t_end) {
+        if (t_end - t_begin > t_grainSize && shouldSplit()) {
+            std::size_t middle = t_begin + (t_end - t_begin) / 2;
+            splits.push_back(submit(
+              IE_THREAD_TYPE_WORKER_THREAD,
+              parallelReduceRange<T, std::remove_reference_t<Map> &, std::remove_reference_t<Reduce> &>(
+                middle,
+                t_end,
+                t_grainSize,
+                t_identity,
+                t_map,
+                t_reduce
+              )
+            ));
+            t_end = middle;
+        } else
+            for (std::size_t end = std::min(t_end, t_begin + t_grainSize); t_begin < end; ++t_begin)
+                result = t_reduce(std::move(result), t_map(t_begin));
+    }
+    co_await resumeAfter(
+      IE_THREAD_TYPE_WORKER_THREAD,
+      std::vector<std::shared_ptr<BaseTask>>{splits.begin(), splits.end()}
+    );
+    // Each split covers a lower part of the range than the one before it, so combine them in reverse.
+    for (auto split = splits.rbegin(); split != splits.rend(); ++split)
+        result = t_reduce(std::move(result), (*split)->value());
+    co_return result;
+}
+
+template<typename Iterator, typename Compare>
+Task<void>
+ThreadPool::parallelSortRange(Iterator t_first, Iterator t_last, std::size_t t_grainSize, Compare t_compare) {
+    std::vector<std::shared_ptr<BaseTask>> splits;
+    while (static_cast<std::size_t>(t_last - t_first) > t_grainSize) {
+        // Partition around the median of the first, middle and last elements.
+        Iterator middle = t_first + (t_last - t_first) / 2;
+        if (t_compare(*middle, *t_first)) std::iter_swap(middle, t_first);
+        if (t_compare(*(t_last - 1), *middle)) {
+            std::iter_swap(t_last - 1, middle);
+            if (t_compare(*middle, *t_first)) std::iter_swap(middle, t_first);
+        }
+        typename std::iterator_traits<Iterator>::value_type pivot{*middle};
+        Iterator lower =
+          std::partition(t_first, t_last, [&](const auto &t_value) { return t_compare(t_value, pivot); });
+        Iterator upper =
+          std::partition(lower, t_last, [&](const auto &t_value) { return !t_compare(pivot, t_value); });
+        // Everything in [lower, upper) is equivalent to the pivot and already in place. Hand the upper part to
+        // another worker and keep going with the lower part.
+        if (upper != t_last)
+            splits.push_back(submit(
+              IE_THREAD_TYPE_WORKER_THREAD,
+              parallelSortRange<Iterator, std::remove_reference_t<Compare> &>(
+                upper,
+                t_last,
+                t_grainSize,
+                t_compare
+              )
+            ));
+        t_last = lower;
+    }
+    std::sort(t_first, t_last, t_compare);
+    co_await resumeAfter(IE_THREAD_TYPE_WORKER_THREAD, splits);
+}
 }  // namespace IE::Core::Threading
\ No newline at end of file
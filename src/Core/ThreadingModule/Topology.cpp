@@ -0,0 +1,120 @@
+#include "Topology.hpp"
+
+#include "Tracer.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#if defined(__linux__) || defined(__APPLE__)
+#    include <pthread.h>
+#endif
+#if defined(__linux__)
+#    include <sched.h>
+#endif
+
+namespace {
+/** Parse a Linux CPU list such as "0-3,8,10-11". */
+std::vector<uint32_t> readCPUList(const std::filesystem::path &t_path) {
+    std::vector<uint32_t> cpus;
+    std::ifstream         file{t_path};
+    std::string           range;
+    while (std::getline(file, range, ',')) {
+        std::istringstream stream{range};
+        uint32_t           first;
+        uint32_t           last;
+        char               dash;
+        if (!(stream >> first)) continue;
+        if (!(stream >> dash >> last) || dash != '-') last = first;
+        for (uint32_t cpu{first}; cpu <= last; ++cpu) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+}  // namespace
+
+IE::Core::Threading::Topology::Topology() {
+#if defined(__linux__)
+    std::error_code error;
+    for (const auto &entry : std::filesystem::directory_iterator("/sys/devices/system/node", error)) {
+        std::string name = entry.path().filename().string();
+        if (!name.starts_with("node") || name.size() == 4 || !std::isdigit(name[4])) continue;
+        std::vector<uint32_t> cpus = readCPUList(entry.path() / "cpulist");
+        if (!cpus.empty()) m_nodes.push_back({static_cast<uint32_t>(std::stoul(name.substr(4))), std::move(cpus)});
+    }
+    std::sort(m_nodes.begin(), m_nodes.end(), [](const Node &a, const Node &b) { return a.id < b.id; });
+
+    // Hybrid Intel processors list their performance cores separately.
+    std::vector<uint32_t> performanceCPUs = readCPUList("/sys/devices/cpu_core/cpus");
+    if (!performanceCPUs.empty()) {
+        for (Node &node : m_nodes) {
+            std::stable_partition(node.cpus.begin(), node.cpus.end(), [&](uint32_t cpu) {
+                return std::find(performanceCPUs.begin(), performanceCPUs.end(), cpu) != performanceCPUs.end();
+            });
+        }
+    }
+#endif
+    if (!m_nodes.empty()) return;
+    Node node{.id = 0, .cpus = {}};
+    for (uint32_t cpu{0}; cpu < std::max(1U, std::thread::hardware_concurrency()); ++cpu) node.cpus.push_back(cpu);
+    m_nodes.push_back(std::move(node));
+}
+
+const IE::Core::Threading::Topology &IE::Core::Threading::Topology::get() {
+    static const Topology topology;
+    return topology;
+}
+
+const std::vector<IE::Core::Threading::Topology::Node> &IE::Core::Threading::Topology::nodes() const {
+    return m_nodes;
+}
+
+IE::Core::Threading::Topology::Placement
+IE::Core::Threading::Topology::place(uint32_t t_workerIndex, IE::Core::Threading::AffinityPolicy t_policy) const {
+    switch (t_policy) {
+        case IE_AFFINITY_POLICY_COMPACT: {
+            std::size_t cpuCount{0};
+            for (const Node &node : m_nodes) cpuCount += node.cpus.size();
+            std::size_t cpu = t_workerIndex % cpuCount;
+            for (uint32_t node{0}; node < m_nodes.size(); ++node) {
+                if (cpu < m_nodes[node].cpus.size()) return {node, {m_nodes[node].cpus[cpu]}};
+                cpu -= m_nodes[node].cpus.size();
+            }
+            break;
+        }
+        case IE_AFFINITY_POLICY_SCATTER: {
+            uint32_t                     node = t_workerIndex % m_nodes.size();
+            const std::vector<uint32_t> &cpus = m_nodes[node].cpus;
+            return {node, {cpus[t_workerIndex / m_nodes.size() % cpus.size()]}};
+        }
+        case IE_AFFINITY_POLICY_NUMA_NODE: {
+            uint32_t node = t_workerIndex % m_nodes.size();
+            return {node, m_nodes[node].cpus};
+        }
+        case IE_AFFINITY_POLICY_NONE: break;
+    }
+    return {NO_NODE, {}};
+}
+
+void IE::Core::Threading::Topology::pinThisThread(const std::vector<uint32_t> &t_cpus) {
+#if defined(__linux__)
+    if (t_cpus.empty()) return;
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (uint32_t cpu : t_cpus)
+        if (cpu < CPU_SETSIZE) CPU_SET(cpu, &cpuSet);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+#endif
+}
+
+void IE::Core::Threading::Topology::nameThisThread(const std::string &t_name) {
+    std::string name = t_name.substr(0, 15);
+#if defined(__linux__)
+    pthread_setname_np(pthread_self(), name.c_str());
+#elif defined(__APPLE__)
+    pthread_setname_np(name.c_str());
+#endif
+    Tracer::nameThisThread(t_name);
+}
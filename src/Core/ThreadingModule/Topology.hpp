@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace IE::Core::Threading {
+enum AffinityPolicy {
+    IE_AFFINITY_POLICY_NONE,       // Let the operating system schedule workers anywhere.
+    IE_AFFINITY_POLICY_COMPACT,    // Pin workers to one CPU each, filling one NUMA node before moving on.
+    IE_AFFINITY_POLICY_SCATTER,    // Pin workers to one CPU each, alternating between NUMA nodes.
+    IE_AFFINITY_POLICY_NUMA_NODE,  // Spread workers over the NUMA nodes, free to run on any CPU of their node.
+};
+
+/**
+ * @brief The processors of this machine, grouped by NUMA node.
+ * @details On Linux the layout is read from sysfs. Within each node, performance cores are listed before
+ * efficiency cores on hybrid processors, so that small pools end up on the fast cores. Everywhere else, and
+ * whenever sysfs can not be read, the machine is treated as a single node.
+ */
+class Topology {
+public:
+    /// The node of a thread that is not bound to any NUMA node.
+    static constexpr uint32_t NO_NODE{std::numeric_limits<uint32_t>::max()};
+
+    struct Node {
+        uint32_t              id;  // The operating system's identifier for this node.
+        std::vector<uint32_t> cpus;
+    };
+
+    struct Placement {
+        uint32_t              node;  // An index into nodes(), or NO_NODE.
+        std::vector<uint32_t> cpus;  // Empty if the thread should not be pinned.
+    };
+
+    static const Topology &get();
+
+    [[nodiscard]] const std::vector<Node> &nodes() const;
+
+    /** @return Where worker number t_workerIndex should run under t_policy. */
+    [[nodiscard]] Placement place(uint32_t t_workerIndex, AffinityPolicy t_policy) const;
+
+    /** Restrict the calling thread to t_cpus. Does nothing on platforms without thread affinity. */
+    static void pinThisThread(const std::vector<uint32_t> &t_cpus);
+
+    /**
+     * @brief Name the calling thread for debuggers and profilers. Names are truncated to 15 characters.
+     * @details Only for threads that the engine starts. Naming the process's main thread would also rename the
+     * process as ps, top and killall see it.
+     */
+    static void nameThisThread(const std::string &t_name);
+
+private:
+    std::vector<Node> m_nodes;
+
+    Topology();
+};
+}  // namespace IE::Core::Threading
@@ -0,0 +1,158 @@
+#include "Tracer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+using IE::Core::Threading::Tracer;
+
+struct Event {
+    const char *name;
+    const void *id;
+    int64_t     start;     // Nanoseconds since recording started.
+    int64_t     duration;  // Nanoseconds. Unused by flow events.
+    char        phase;     // 'X' for a zone, 's' and 'f' for the start and end of a flow arrow.
+};
+
+/** The events of one thread. Only its own thread records into it, so the mutex is only ever contended on write. */
+struct ThreadBuffer {
+    std::mutex         mutex;
+    std::vector<Event> events;
+    std::size_t        next{0};
+    std::size_t        count{0};
+    uint32_t           threadID{0};
+    std::string        name;
+};
+
+struct Registry {
+    std::mutex                                 mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    // When recording last started. Read by every recording thread without the lock, so it is kept atomic.
+    std::atomic<Tracer::Clock::rep>            epoch{Tracer::Clock::now().time_since_epoch().count()};
+};
+
+// Threads may record while static objects are being destroyed, so the registry is intentionally never destroyed.
+Registry &registry() {
+    static auto *registry = new Registry{};
+    return *registry;
+}
+
+ThreadBuffer &threadBuffer() {
+    // The registry keeps the buffer alive after the thread exits, so that its events are still written out.
+    thread_local std::shared_ptr<ThreadBuffer> buffer = [] {
+        Registry                   &registry = ::registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        auto                        buffer = std::make_shared<ThreadBuffer>();
+        buffer->threadID                   = registry.buffers.size();
+        registry.buffers.push_back(buffer);
+        return buffer;
+    }();
+    return *buffer;
+}
+
+int64_t sinceEpoch(Tracer::Clock::time_point t_time) {
+    Tracer::Clock::time_point epoch{Tracer::Clock::duration{registry().epoch.load(std::memory_order_relaxed)}};
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t_time - epoch).count();
+}
+
+void record(const Event &t_event) {
+    ThreadBuffer               &buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    if (buffer.events.empty()) buffer.events.resize(Tracer::EVENTS_PER_THREAD);
+    buffer.events[buffer.next] = t_event;
+    buffer.next                = (buffer.next + 1) % Tracer::EVENTS_PER_THREAD;
+    buffer.count               = std::min(buffer.count + 1, Tracer::EVENTS_PER_THREAD);
+}
+
+std::string escape(const std::string &t_string) {
+    std::string escaped;
+    for (char character : t_string) {
+        if (character == '"' || character == '\\') escaped += '\\';
+        if (static_cast<unsigned char>(character) >= 0x20) escaped += character;
+    }
+    return escaped;
+}
+}  // namespace
+
+std::atomic<bool> IE::Core::Threading::Tracer::m_recording{false};
+
+void IE::Core::Threading::Tracer::start() {
+    Registry                   &registry = ::registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (const std::shared_ptr<ThreadBuffer> &buffer : registry.buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        buffer->next  = 0;
+        buffer->count = 0;
+    }
+    registry.epoch.store(Clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+    m_recording.store(true, std::memory_order_relaxed);
+}
+
+void IE::Core::Threading::Tracer::stop() {
+    m_recording.store(false, std::memory_order_relaxed);
+}
+
+void IE::Core::Threading::Tracer::flowStart(const void *t_id) {
+    if (recording()) record({"Resume", t_id, sinceEpoch(Clock::now()), 0, 's'});
+}
+
+void IE::Core::Threading::Tracer::flowEnd(const void *t_id) {
+    if (recording()) record({"Resume", t_id, sinceEpoch(Clock::now()), 0, 'f'});
+}
+
+void IE::Core::Threading::Tracer::nameThisThread(const std::string &t_name) {
+    ThreadBuffer               &buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.name = t_name;
+}
+
+bool IE::Core::Threading::Tracer::writeChromeTrace(const std::filesystem::path &t_path) {
+    std::ofstream file{t_path, std::ios::out | std::ios::trunc};
+    if (!file.is_open()) return false;
+    // Timestamps are in microseconds. Keep every nanosecond, as the default six significant digits would round
+    // them to tens of microseconds within seconds of starting, and zones would no longer nest.
+    file << std::fixed << std::setprecision(3);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool                        first{true};
+    Registry                   &registry = ::registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (const std::shared_ptr<ThreadBuffer> &buffer : registry.buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        if (!buffer->name.empty()) {
+            file << (first ? "" : ",\n") << R"({"ph":"M","name":"thread_name","pid":0,"tid":)" << buffer->threadID
+                 << R"(,"args":{"name":")" << escape(buffer->name) << "\"}}";
+            first = false;
+        }
+        // Oldest first, starting just after the most recently recorded event once the ring has wrapped.
+        std::size_t oldest = (buffer->next + EVENTS_PER_THREAD - buffer->count) % EVENTS_PER_THREAD;
+        for (std::size_t i{0}; i < buffer->count; ++i) {
+            const Event &event = buffer->events[(oldest + i) % EVENTS_PER_THREAD];
+            file << (first ? "" : ",\n") << R"({"ph":")" << event.phase << R"(","name":")" << escape(event.name)
+                 << R"(","cat":"task","pid":0,"tid":)" << buffer->threadID << ",\"ts\":" << event.start / 1000.0;
+            if (event.phase == 'X')
+                file << ",\"dur\":" << event.duration / 1000.0 << R"(,"args":{"id":")" << event.id << "\"}}";
+            else
+                file << ",\"id\":" << reinterpret_cast<std::uintptr_t>(event.id)
+                     << (event.phase == 'f' ? R"(,"bp":"e"})" : "}");
+            first = false;
+        }
+    }
+    file << "\n]}\n";
+    return file.good();
+}
+
+void IE::Core::Threading::Tracer::recordZone(
+  const char       *t_name,
+  const void       *t_id,
+  Clock::time_point t_start,
+  Clock::time_point t_end
+) {
+    int64_t duration = std::chrono::duration_cast<std::chrono::nanoseconds>(t_end - t_start).count();
+    record({t_name, t_id, sinceEpoch(t_start), duration, 'X'});
+}
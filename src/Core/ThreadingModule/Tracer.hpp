@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+
+namespace IE::Core::Threading {
+/**
+ * @brief Records timed zones on every thread, to be viewed as a Chrome trace in chrome://tracing or Perfetto.
+ * @details Each thread records into a ring buffer of its own, which keeps the last EVENTS_PER_THREAD events.
+ * Nothing is recorded until start() is called, and while not recording a zone costs a single relaxed load.
+ * Names must be string literals, or otherwise outlive the recording. Every task the thread pool executes is
+ * recorded as a zone, and a flow arrow is drawn from each task to the coroutine that it resumes.
+ */
+class Tracer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::size_t EVENTS_PER_THREAD{1 << 16};
+
+    /** Records the time from its construction to its destruction as a zone on the calling thread. */
+    class Zone {
+    public:
+        /** t_id is shown with the zone, such as the address of the task that it belongs to. */
+        explicit Zone(const char *t_name, const void *t_id = nullptr) :
+                m_name(t_name),
+                m_id(t_id),
+                m_active(recording()) {
+            if (m_active) m_start = Clock::now();
+        }
+
+        Zone(const Zone &) = delete;
+
+        Zone &operator=(const Zone &) = delete;
+
+        ~Zone() {
+            if (m_active) recordZone(m_name, m_id, m_start, Clock::now());
+        }
+
+    private:
+        const char       *m_name;
+        const void       *m_id;
+        bool              m_active;
+        Clock::time_point m_start{};
+    };
+
+    /** Throw away anything previously recorded and start recording. */
+    static void start();
+
+    static void stop();
+
+    static bool recording() {
+        return m_recording.load(std::memory_order_relaxed);
+    }
+
+    /** Start a flow arrow from the calling thread's current zone. It ends at the matching call to flowEnd(). */
+    static void flowStart(const void *t_id);
+
+    static void flowEnd(const void *t_id);
+
+    /** Set the name that the calling thread is shown with. */
+    static void nameThisThread(const std::string &t_name);
+
+    /**
+     * @brief Write everything recorded so far to t_path in the Chrome trace event format.
+     * @return False if the file could not be written.
+     */
+    static bool writeChromeTrace(const std::filesystem::path &t_path);
+
+private:
+    static std::atomic<bool> m_recording;
+
+    static void
+      recordZone(const char *t_name, const void *t_id, Clock::time_point t_start, Clock::time_point t_end);
+};
+}  // namespace IE::Core::Threading
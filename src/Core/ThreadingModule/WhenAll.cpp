@@ -0,0 +1 @@
+#include "WhenAll.hpp"
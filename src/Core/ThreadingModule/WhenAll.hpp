@@ -0,0 +1,93 @@
+#pragma once
+
+#include "ResumeAfter.hpp"
+#include "Task.hpp"
+
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace IE::Core::Threading {
+class ThreadPool;
+
+namespace detail {
+/// Tasks that return nothing are represented by std::monostate in the results of a WhenAll.
+template<typename T>
+using WhenAllResult = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+template<typename T>
+WhenAllResult<T> resultOf(Task<T> &t_task) {
+    if constexpr (std::is_void_v<T>) return {};
+    else return t_task.value();
+}
+}  // namespace detail
+
+/**
+ * @brief Suspends the awaiting coroutine until all of the given tasks have finished, then returns their results as
+ * a tuple.
+ * @details However many tasks there are, they are all waited on through a single ResumeAfter that lives inside
+ * this awaitable.
+ */
+template<typename... T>
+class WhenAll {
+public:
+    WhenAll(ThreadPool *t_threadPool, ThreadType t_threadType, std::shared_ptr<Task<T>>... t_tasks) :
+            m_resumeAfter(t_threadPool, t_threadType, t_tasks...),
+            m_tasks(std::move(t_tasks)...) {
+    }
+
+    bool await_ready() {
+        return m_resumeAfter.await_ready();
+    }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> t_handle) {
+        return m_resumeAfter.await_suspend(t_handle);
+    }
+
+    std::tuple<detail::WhenAllResult<T>...> await_resume() {
+        return std::apply(
+          [](std::shared_ptr<Task<T>> &...t_tasks) { return std::make_tuple(detail::resultOf(*t_tasks)...); },
+          m_tasks
+        );
+    }
+
+private:
+    ResumeAfter                             m_resumeAfter;
+    std::tuple<std::shared_ptr<Task<T>>...> m_tasks;
+};
+
+/** The same as WhenAll, for any number of tasks that return the same type. Results are returned in order. */
+template<typename T>
+class WhenAllOf {
+public:
+    WhenAllOf(ThreadPool *t_threadPool, ThreadType t_threadType, std::vector<std::shared_ptr<Task<T>>> t_tasks) :
+            m_resumeAfter(t_threadPool, t_threadType),
+            m_tasks(std::move(t_tasks)) {
+        for (const std::shared_ptr<Task<T>> &task : m_tasks) m_resumeAfter.addDependency(task);
+    }
+
+    bool await_ready() {
+        return m_resumeAfter.await_ready();
+    }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> t_handle) {
+        return m_resumeAfter.await_suspend(t_handle);
+    }
+
+    auto await_resume() {
+        if constexpr (std::is_void_v<T>) return;
+        else {
+            std::vector<T> results;
+            results.reserve(m_tasks.size());
+            for (const std::shared_ptr<Task<T>> &task : m_tasks) results.push_back(task->value());
+            return results;
+        }
+    }
+
+private:
+    ResumeAfter                           m_resumeAfter;
+    std::vector<std::shared_ptr<Task<T>>> m_tasks;
+};
+}  // namespace IE::Core::Threading
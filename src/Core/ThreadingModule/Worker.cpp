@@ -2,65 +2,270 @@
 
 #include "BaseTask.hpp"
 #include "ThreadPool.hpp"
+#include "Tracer.hpp"
 
 #include <atomic>
+#include <functional>
 #include <memory>
-#include <mutex>
+#include <string>
+#include <thread>
 
-void IE::Core::Threading::Worker::start(ThreadPool *t_threadPool) {
-    ThreadPool                  &pool = *t_threadPool;
-    std::shared_ptr<BaseTask>    task;
-    std::mutex                   mutex;
-    std::unique_lock<std::mutex> lock(mutex);
+thread_local IE::Core::Threading::Worker     *IE::Core::Threading::Worker::m_current{nullptr};
+thread_local IE::Core::Threading::ThreadPool *IE::Core::Threading::Worker::m_currentThreadPool{nullptr};
+thread_local uint32_t                         IE::Core::Threading::Worker::m_currentNode{Topology::NO_NODE};
+
+void IE::Core::Threading::Worker::start(ThreadPool *t_threadPool, uint32_t t_index) {
+    ThreadPool               &pool = *t_threadPool;
+    Worker                   *self = claim(pool);
+    std::shared_ptr<BaseTask> task;
+    m_currentThreadPool     = &pool;
+    // A worker without a slot keeps its own arena, but still resets it between tasks.
+    ScratchArena::m_current = self != nullptr ? &self->m_scratchArena : &ScratchArena::current();
+#if defined(IE_THREADING_STATISTICS)
+    ThreadStatistics::m_current = self != nullptr ? &self->m_statistics : nullptr;
+#endif
+
+    Topology::Placement placement = Topology::get().place(t_index, pool.m_affinityPolicy);
+    Topology::pinThisThread(placement.cpus);
+    Topology::nameThisThread("IE Worker " + std::to_string(t_index));
+    // Only bind to a node that the pool has a queue for.
+    m_currentNode = placement.node < pool.m_nodeQueues.size() ? placement.node : Topology::NO_NODE;
 
     // Main working loop
-    while (true) {
-        // If threads are being asked to shut down, ensure that the number of threads to shut down is correctly
-        // synchronized.
-        for (uint32_t n = pool.m_threadShutdownCount.load(); pool.m_threadShutdownCount > 0;)
-            if (pool.m_threadShutdownCount.compare_exchange_weak(n, n - 1, std::memory_order_relaxed)) return;
-        // Wait until this thread is requested to awaken.
-        if (!pool.m_queue.pop(task))
-            pool.m_workAssignedNotifier.wait(lock, [&] {
-                return pool.m_queue.pop(task) || (pool.m_threadShutdownCount > 0);
-            });
-        // If threads are being asked to shut down, ensure that the number of threads to shut down is correctly
-        // synchronized.
-        for (uint32_t n = pool.m_threadShutdownCount.load(); pool.m_threadShutdownCount > 0;)
-            if (pool.m_threadShutdownCount.compare_exchange_weak(n, n - 1, std::memory_order_relaxed)) {
-                if (task) {
-                    pool.m_queue.push(task);
-                    pool.m_workAssignedNotifier.notify_one();
-                }
-                return;
-            }
+    ThreadStatistics::Clock::time_point idleSince = ThreadStatistics::now();
+    while (!claimShutdown(pool)) {
+        bool                                found     = findTask(pool, task) || park(pool, task);
+        ThreadStatistics::Clock::time_point busySince = ThreadStatistics::now();
+        ThreadStatistics::countTime(&ThreadStatistics::idleNanoseconds, idleSince, busySince);
+        idleSince = busySince;
+        if (!found) continue;
         // Execute the task, then nullify it
-        if (task) {
-            task->execute();
-            task = nullptr;
-        }
+        execute(task);
+        task      = nullptr;
+        idleSince = ThreadStatistics::now();
+        ThreadStatistics::countTime(&ThreadStatistics::busyNanoseconds, busySince, idleSince);
     }
+    if (self != nullptr) self->release();
+    m_currentThreadPool     = nullptr;
+    ScratchArena::m_current = nullptr;
+#if defined(IE_THREADING_STATISTICS)
+    ThreadStatistics::m_current = nullptr;
+#endif
 }
 
 /** Note that while waiting for a task to complete, this thread ignores all shutdown signals. */
 void IE::Core::Threading::Worker::waitForTask(IE::Core::Threading::ThreadPool *t_threadPool, BaseTask &t_task) {
-    if (t_task.finished()) return;
-    ThreadPool                  &pool = *t_threadPool;
-    std::shared_ptr<BaseTask>    task;
-    std::mutex                   mutex;
-    std::unique_lock<std::mutex> lock(mutex);
-
-    while (true) {
-        if (t_task.finished()) return;
-        if (!pool.m_queue.pop(task))
-            t_task.m_finishedNotifier->wait(lock, [&] { return pool.m_queue.pop(task) || t_task.finished(); });
-        if (t_task.finished()) {
-            pool.m_queue.push(task);
-            pool.m_workAssignedNotifier.notify_one();
-        }
-        if (task) {
-            task->execute();
+    ThreadPool               &pool = *t_threadPool;
+    std::shared_ptr<BaseTask> task;
+    // A deterministic pool's main thread may be playing one of its workers, but it still has to sleep like the
+    // main thread.
+    bool                      mainThread = std::this_thread::get_id() == pool.mainThreadID;
+
+    // Work that the main thread helps with may submit more main thread work, which only this thread can run. The
+    // main thread therefore sleeps on its own event count and has the task bump it when it finishes.
+    if (mainThread) t_task.m_finishedEpoch = &pool.m_mainWorkEpoch;
+    // The main thread may itself be running a task that waits, so only the outermost wait clears this.
+    bool wasWaiting = mainThread && pool.m_mainThreadWaiting.exchange(true);
+    bool poolWorker = !mainThread && m_currentThreadPool == &pool;
+
+    // Help execute other tasks until there are none left, then sleep until the task has finished.
+    while (!t_task.finished()) {
+        uint32_t epoch = pool.m_mainWorkEpoch.load();
+        if (pool.m_schedule != nullptr) {
+            // Only the main thread may run the tasks of a deterministic pool, which it does itself.
+            if (mainThread && pool.runScheduled()) continue;
+        } else if ((mainThread && pool.mainThreadWorkAllowed() && pool.m_mainQueue.pop(task)) ||
+                   findTask(pool, task)) {
+            execute(task);
             task = nullptr;
+            continue;
         }
+        if (mainThread) {
+            if (!t_task.finished()) pool.m_mainWorkEpoch.wait(epoch);
+            continue;
+        }
+        if (poolWorker) {
+            pool.m_waitingWorkers.fetch_add(1);
+            pool.notifyWaitingMainThread();
+        }
+        t_task.m_finished.wait(false);
+        if (poolWorker) pool.m_waitingWorkers.fetch_sub(1);
+    }
+    if (mainThread) pool.m_mainThreadWaiting = wasWaiting;
+}
+
+IE::Core::Threading::Worker *IE::Core::Threading::Worker::current() {
+    return m_current;
+}
+
+IE::Core::Threading::ThreadPool *IE::Core::Threading::Worker::currentThreadPool() {
+    return m_currentThreadPool;
+}
+
+IE::Core::Threading::TaskPriority IE::Core::Threading::Worker::currentPriority() {
+    BaseTask *task = BaseTask::current();
+    return task != nullptr ? task->m_priority : IE_TASK_PRIORITY_NORMAL;
+}
+
+IE::Core::Threading::CancellationToken IE::Core::Threading::Worker::currentCancellationToken() {
+    BaseTask *task = BaseTask::current();
+    return task != nullptr ? task->m_cancellationToken : CancellationToken{};
+}
+
+uint32_t IE::Core::Threading::Worker::currentNode() {
+    return m_currentNode;
+}
+
+void IE::Core::Threading::Worker::execute(const std::shared_ptr<BaseTask> &t_task) {
+    // Tasks may execute other tasks while they wait, so restore the outer task afterwards.
+    BaseTask *previousTask          = BaseTask::m_current;
+    uint32_t  previousContinuations = BaseTask::m_inlineContinuations;
+    BaseTask::m_current             = t_task.get();
+    BaseTask::m_inlineContinuations = 0;
+    ThreadStatistics::count(&ThreadStatistics::tasksExecuted);
+    ThreadStatistics::taskStarted(*t_task);
+    {
+        Tracer::Zone zone{"Task", t_task.get()};
+        t_task->execute();
+    }
+    BaseTask::m_current             = previousTask;
+    BaseTask::m_inlineContinuations = previousContinuations;
+    // Only threads that belong to a pool have their arena reset, as anything else may still be using its own.
+    if (previousTask == nullptr && ScratchArena::m_current != nullptr) ScratchArena::m_current->reset();
+}
+
+void IE::Core::Threading::Worker::push(std::shared_ptr<BaseTask> t_task) {
+    BaseTask *task = t_task.get();
+    // The deque only holds raw pointers, so the task keeps itself alive until it is taken off again.
+    task->m_self   = std::move(t_task);
+    m_deque.push(task);
+}
+
+bool IE::Core::Threading::Worker::pop(std::shared_ptr<BaseTask> &t_task) {
+    BaseTask *task;
+    if (!m_deque.pop(task)) return false;
+    t_task = std::move(task->m_self);
+    return true;
+}
+
+bool IE::Core::Threading::Worker::steal(std::shared_ptr<BaseTask> &t_task) {
+    BaseTask *task;
+    if (!m_deque.steal(task)) return false;
+    t_task = std::move(task->m_self);
+    return true;
+}
+
+bool IE::Core::Threading::Worker::stealFromOthers(
+  ThreadPool                &t_threadPool,
+  Worker                    *t_self,
+  std::shared_ptr<BaseTask> &t_task
+) {
+    // Start at a pseudo-random victim so that thieves do not all contend on the same deque. A deterministic pool
+    // has its schedule pick the victim instead, as the seed differs from run to run.
+    thread_local uint32_t seed{static_cast<uint32_t>(std::hash<std::thread::id>{}(std::this_thread::get_id()))};
+    seed                     = seed * 1664525 + 1013904223;
+    uint32_t workerSlotCount = t_threadPool.m_workerSlotsInUse.load(std::memory_order_acquire);
+    uint32_t first = t_threadPool.m_schedule != nullptr && workerSlotCount > 0 ?
+                       t_threadPool.nextChoice(workerSlotCount) :
+                       seed;
+    for (uint32_t i{0}; i < workerSlotCount; ++i) {
+        Worker &victim = t_threadPool.m_workerSlots[(first + i) % workerSlotCount];
+        if (&victim == t_self || !victim.steal(t_task)) continue;
+        ThreadStatistics::count(&ThreadStatistics::steals);
+        return true;
+    }
+    return false;
+}
+
+bool IE::Core::Threading::Worker::findTask(ThreadPool &t_threadPool, std::shared_ptr<BaseTask> &t_task) {
+    Worker *self = m_current != nullptr && m_current->m_threadPool == &t_threadPool ? m_current : nullptr;
+    Queue<std::shared_ptr<BaseTask>> &backgroundQueue = t_threadPool.m_queues[IE_TASK_PRIORITY_BACKGROUND];
+    // The number of tasks that this thread has taken since it last took a background task.
+    thread_local uint32_t             tasksSinceBackground{0};
+
+    // Frame-critical work always comes first, followed by work meant for this thread's NUMA node.
+    if (t_threadPool.m_queues[IE_TASK_PRIORITY_FRAME_CRITICAL].pop(t_task)) return true;
+    bool onNode = self != nullptr && m_currentNode != Topology::NO_NODE;
+    if (onNode && t_threadPool.m_nodeQueues[m_currentNode]->pop(t_task)) return true;
+
+    // Age waiting background work so that a steady stream of normal work can not starve it.
+    if (tasksSinceBackground >= BACKGROUND_AGING_INTERVAL && backgroundQueue.pop(t_task)) {
+        tasksSinceBackground = 0;
+        return true;
+    }
+
+    // Prefer this worker's own most recently submitted work, then work submitted from outside the pool, then work
+    // stolen from the other workers.
+    if ((self != nullptr && self->pop(t_task)) || t_threadPool.m_queues[IE_TASK_PRIORITY_NORMAL].pop(t_task) ||
+        stealFromOthers(t_threadPool, self, t_task)) {
+        ++tasksSinceBackground;
+        return true;
+    }
+
+    if (backgroundQueue.pop(t_task)) {
+        tasksSinceBackground = 0;
+        return true;
+    }
+
+    // Rather than sit idle, help out with work meant for other nodes.
+    for (const auto &queue : t_threadPool.m_nodeQueues)
+        if (queue->pop(t_task)) return true;
+    return false;
+}
+
+bool IE::Core::Threading::Worker::park(ThreadPool &t_threadPool, std::shared_ptr<BaseTask> &t_task) {
+    // Work usually shows up again quickly, so spin for a little while before going to sleep.
+    for (uint32_t spin{0}; spin < SPIN_COUNT; ++spin) {
+        if (findTask(t_threadPool, t_task)) return true;
+        std::this_thread::yield();
+    }
+
+    // Announce that this thread is about to sleep, then check one last time. Any submission made after the epoch
+    // was read changes it, so the wait below can never miss a wakeup.
+    uint32_t epoch = t_threadPool.m_workEpoch.load();
+    t_threadPool.m_sleepingWorkers.fetch_add(1);
+    t_threadPool.notifyWaitingMainThread();
+    bool found = findTask(t_threadPool, t_task);
+    if (!found && t_threadPool.m_threadShutdownCount == 0) {
+        t_threadPool.m_workEpoch.wait(epoch);
+        ThreadStatistics::count(&ThreadStatistics::wakeups);
+    }
+    t_threadPool.m_sleepingWorkers.fetch_sub(1);
+    return found;
+}
+
+bool IE::Core::Threading::Worker::claimShutdown(ThreadPool &t_threadPool) {
+    // If threads are being asked to shut down, ensure that the number of threads to shut down is correctly
+    // synchronized.
+    for (uint32_t n = t_threadPool.m_threadShutdownCount.load(); n > 0;)
+        if (t_threadPool.m_threadShutdownCount.compare_exchange_weak(n, n - 1, std::memory_order_relaxed))
+            return true;
+    return false;
+}
+
+IE::Core::Threading::Worker *IE::Core::Threading::Worker::claim(ThreadPool &t_threadPool) {
+    for (uint32_t i{0}; i < ThreadPool::MAX_WORKERS; ++i) {
+        Worker &slot = t_threadPool.m_workerSlots[i];
+        bool    claimed{false};
+        if (!slot.m_claimed.compare_exchange_strong(claimed, true, std::memory_order_acq_rel)) continue;
+        // Make sure that thieves will look at this slot.
+        for (uint32_t n = t_threadPool.m_workerSlotsInUse.load(); n < i + 1;)
+            if (t_threadPool.m_workerSlotsInUse.compare_exchange_weak(n, i + 1, std::memory_order_release)) break;
+        return m_current = &slot;
+    }
+    // There are more workers than slots. This worker will run without a deque of its own.
+    return nullptr;
+}
+
+void IE::Core::Threading::Worker::release() {
+    // Hand any remaining local work to the other workers before giving up the slot.
+    std::shared_ptr<BaseTask> task;
+    bool                      released{false};
+    while (pop(task)) {
+        m_threadPool->m_queues[IE_TASK_PRIORITY_NORMAL].push(task);
+        released = true;
     }
+    if (released) m_threadPool->notifyAllWorkers();
+    m_current = nullptr;
+    m_claimed.store(false, std::memory_order_release);
 }
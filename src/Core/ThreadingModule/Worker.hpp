@@ -1,14 +1,102 @@
 #pragma once
 
 #include "BaseTask.hpp"
+#include "Deque.hpp"
+#include "ScratchArena.hpp"
+#include "Statistics.hpp"
+#include "Topology.hpp"
+
+#include <atomic>
+#include <memory>
 
 namespace IE::Core::Threading {
 class ThreadPool;
 
+/**
+ * @brief The per-thread state of a thread pool worker.
+ * @details Every worker owns a work-stealing deque. Tasks submitted from a worker thread are pushed onto that
+ * worker's deque and popped again in LIFO order, keeping recursive fan-out close to the data it works on. Idle
+ * workers steal from the other end of each other's deques.
+ */
 class Worker {
 public:
-    static void start(ThreadPool *t_threadPool);
+    /// The number of times an idle worker looks for work before it parks.
+    static constexpr uint32_t SPIN_COUNT{64};
+    /// The number of other tasks a worker takes before it lets waiting background work jump the queue.
+    static constexpr uint32_t BACKGROUND_AGING_INTERVAL{16};
+
+    /** Run as worker number t_index of t_threadPool until told to shut down. */
+    static void start(ThreadPool *t_threadPool, uint32_t t_index);
 
     static void waitForTask(ThreadPool *t_threadPool, BaseTask &t_task);
+
+    /** @return The worker that the calling thread is running as, or nullptr if it is not a worker thread. */
+    static Worker *current();
+
+    /**
+     * @return The pool that the calling thread is a worker of, or nullptr if it is not a worker thread. Unlike
+     * current(), this is also set for workers that did not get a slot of their own.
+     */
+    static ThreadPool *currentThreadPool();
+
+    /**
+     * @return The priority of the task that the calling thread is executing, or IE_TASK_PRIORITY_NORMAL if it is
+     * not executing one. Work submitted without an explicit priority inherits this.
+     */
+    static TaskPriority currentPriority();
+
+    /**
+     * @return The cancellation token of the task that the calling thread is executing, or a token that can not be
+     * cancelled if it is not executing one. Work submitted without an explicit token inherits this.
+     */
+    static CancellationToken currentCancellationToken();
+
+    /** @return The index of the NUMA node that the calling thread is bound to, or Topology::NO_NODE. */
+    static uint32_t currentNode();
+
+    /** Push a task onto this worker's deque. May only be called from the thread that owns this worker. */
+    void push(std::shared_ptr<BaseTask> t_task);
+
+private:
+    Deque<BaseTask *> m_deque;
+    std::atomic<bool> m_claimed{false};
+    ThreadPool       *m_threadPool{};
+    ScratchArena      m_scratchArena;
+#if defined(IE_THREADING_STATISTICS)
+    ThreadStatistics m_statistics;
+#endif
+
+    static thread_local Worker     *m_current;
+    static thread_local ThreadPool *m_currentThreadPool;
+    static thread_local uint32_t    m_currentNode;
+
+    /**
+     * @brief Execute a task with it set as the calling thread's current task.
+     * @details Once the outermost task that the thread is executing returns, the thread's scratch arena is reset.
+     */
+    static void execute(const std::shared_ptr<BaseTask> &t_task);
+
+    bool pop(std::shared_ptr<BaseTask> &t_task);
+
+    bool steal(std::shared_ptr<BaseTask> &t_task);
+
+    /** Steal from the deques of the pool's workers other than t_self. */
+    static bool stealFromOthers(ThreadPool &t_threadPool, Worker *t_self, std::shared_ptr<BaseTask> &t_task);
+
+    static bool findTask(ThreadPool &t_threadPool, std::shared_ptr<BaseTask> &t_task);
+
+    /**
+     * @brief Spin briefly, then sleep until work is published.
+     * @return True if a task was found. False if the worker woke up without one.
+     */
+    static bool park(ThreadPool &t_threadPool, std::shared_ptr<BaseTask> &t_task);
+
+    static bool claimShutdown(ThreadPool &t_threadPool);
+
+    static Worker *claim(ThreadPool &t_threadPool);
+
+    void release();
+
+    friend class ThreadPool;
 };
 }  // namespace IE::Core::Threading
@@ -1,6 +1,7 @@
 #include "IECommandBuffer.hpp"
 
 #include "Core/LogModule/Logger.hpp"
+#include "Core/ThreadingModule/Tracer.hpp"
 #include "GraphicsModule/Shader/IEDescriptorSet.hpp"
 #include "GraphicsModule/Shader/IEPipeline.hpp"
 #include "IEDependency.hpp"
@@ -149,6 +150,7 @@ void IECommandBuffer::finish(bool synchronize) {
 }
 
 void IECommandBuffer::execute(VkSemaphore input, VkSemaphore output, VkFence fence) {
+    IE::Core::Threading::Tracer::Zone zone{"IECommandBuffer::execute", this};
     wait();
     commandPool->commandPoolMutex.lock();
     //    executionThread = std::thread{[&] {
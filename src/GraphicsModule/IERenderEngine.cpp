@@ -8,6 +8,7 @@
 #include "Core/AssetModule/IEAsset.hpp"
 #include "Core/Core.hpp"
 #include "Core/LogModule/Logger.hpp"
+#include "Core/ThreadingModule/Tracer.hpp"
 
 #include <vulkan/vulkan_core.h>
 
@@ -337,6 +338,8 @@ void IERenderEngine::destroyCommandPools() {
 }
 
 IERenderEngine::IERenderEngine(IESettings *settings) : settings(settings) {
+    if (settings->traceFrames > 0) IE::Core::Threading::Tracer::start();
+
     // Create a Vulkan instance
     createVulkanInstance();
 
@@ -413,6 +416,7 @@ IERenderEngine::IERenderEngine(IESettings *settings) : settings(settings) {
 
     graphicsCommandPool->index(0)->execute();
     camera.create(this);
+    createFrameGraph();
     settings->logger.log(
       device.physical_device.properties.deviceName,
       IE::Core::Logger::ILLUMINATION_ENGINE_LOG_LEVEL_INFO
@@ -421,6 +425,7 @@ IERenderEngine::IERenderEngine(IESettings *settings) : settings(settings) {
 }
 
 void IERenderEngine::addAsset(const std::shared_ptr<IEAsset> &asset) {
+    IE::Core::Threading::Tracer::Zone zone{"Load asset", asset.get()};
     for (std::shared_ptr<IEAspect> &aspect : asset->aspects) {
         // If aspect is downcast-able to a renderable
         if (dynamic_cast<IERenderable *>(aspect.get())) {
@@ -454,9 +459,47 @@ void IERenderEngine::handleResolutionChange() {
 }
 
 bool IERenderEngine::update() {
+#if defined(IE_THREADING_STATISTICS)
+    if (frameNumber % THREADING_STATISTICS_INTERVAL == 0) {
+        settings->logger.log(
+          "Thread pool statistics at frame #" + std::to_string(frameNumber) + ":\n" +
+            IE::Core::Core::getThreadPool()->getStatistics().toString(),
+          IE::Core::Logger::ILLUMINATION_ENGINE_LOG_LEVEL_INFO
+        );
+    }
+#endif
+    if (settings->traceFrames > 0 && frameNumber == settings->traceFrames) {
+        IE::Core::Threading::Tracer::stop();
+        writeTrace();
+    }
+    IE::Core::Threading::Tracer::Zone zone{"Frame"};
+    // The game loop is a task that never finishes, so the scratch memory of each frame is freed when it ends.
+    IE::Core::Threading::ScratchArena::Scope scratchScope;
+    {
+        IE::Core::Threading::Tracer::Zone pumpZone{"Main thread work"};
+        IE::Core::Core::getThreadPool()->pumpMainThread(MAIN_THREAD_BUDGET);
+    }
     return _update(*this);
 }
 
+bool IERenderEngine::writeTrace() {
+    IE::Core::FileSystem *fileSystem = IE::Core::Core::getFileSystem();
+    std::filesystem::path path{"traces/Frame " + std::to_string(frameNumber) + ".json"};
+    fileSystem->createFolder(path.parent_path());
+    if (IE::Core::Threading::Tracer::writeChromeTrace(fileSystem->makePathAbsolute(path))) {
+        settings->logger.log(
+          "Wrote trace to " + path.string(),
+          IE::Core::Logger::ILLUMINATION_ENGINE_LOG_LEVEL_INFO
+        );
+        return true;
+    }
+    settings->logger.log(
+      "Failed to write trace to " + path.string(),
+      IE::Core::Logger::ILLUMINATION_ENGINE_LOG_LEVEL_WARN
+    );
+    return false;
+}
+
 bool IERenderEngine::_openGLUpdate() {
     if (framebufferResized) {
         framebufferResized = false;
@@ -492,65 +535,12 @@ bool IERenderEngine::_vulkanUpdate() {
         shouldBeFullscreen = false;
         toggleFullscreen();
     }
-    vkWaitForFences(device.device, 1, &inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
-    uint32_t imageIndex{0};
-    VkResult result = vkAcquireNextImageKhr(
-      device.device,
-      swapchain.swapchain,
-      UINT64_MAX,
-      imageAvailableSemaphores[currentFrame],
-      VK_NULL_HANDLE,
-      &imageIndex
-    );
-    if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) handleResolutionChange();
-    if (imagesInFlight[imageIndex] != VK_NULL_HANDLE)
-        vkWaitForFences(device.device, 1, &imagesInFlight[imageIndex], VK_TRUE, UINT64_MAX);
-    imagesInFlight[imageIndex] = inFlightFences[currentFrame];
-    VkViewport viewport{
-      .x        = 0.0F,
-      .y        = 0.0F,
-      .width    = (float) swapchain.extent.width,
-      .height   = (float) swapchain.extent.height,
-      .minDepth = 0.0F,
-      .maxDepth = 1.0F};
-    graphicsCommandPool->index(imageIndex)->recordSetViewport(0, 1, &viewport);
-    VkRect2D scissor{
-      .offset = {0, 0},
-      .extent = swapchain.extent,
-    };
-    graphicsCommandPool->index(imageIndex)->recordSetScissor(0, 1, &scissor);
-    IERenderPassBeginInfo renderPassBeginInfo = renderPass->beginRenderPass(imageIndex);
-    graphicsCommandPool->index(imageIndex)
-      ->recordBeginRenderPass(&renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
-    camera.update();
-    for (const std::weak_ptr<IERenderable> &renderable : renderables) renderable.lock()->update(imageIndex);
-    graphicsCommandPool->index(imageIndex)->recordEndRenderPass();
-    graphicsCommandPool->index(imageIndex)
-      ->execute(
-        imageAvailableSemaphores[currentFrame],
-        renderFinishedSemaphores[currentFrame],
-        inFlightFences[currentFrame]
-      );
-    VkPresentInfoKHR presentInfo{
-      .sType              = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
-      .waitSemaphoreCount = 1,
-      .pWaitSemaphores    = &renderFinishedSemaphores[currentFrame],
-      .swapchainCount     = 1,
-      .pSwapchains        = &swapchain.swapchain,
-      .pImageIndices      = &imageIndex,
-    };
-    graphicsCommandPool->index(imageIndex)->commandPool->commandPoolMutex.lock();
-    result = vkQueuePresentKHR(presentQueue, &presentInfo);
-    graphicsCommandPool->index(imageIndex)->commandPool->commandPoolMutex.unlock();
-    if (result != VK_SUCCESS && result != VK_ERROR_OUT_OF_DATE_KHR)
-        settings->logger.log(
-          "Failed to present image! Error: " + translateVkResultCodes(result),
-          IE::Core::Logger::ILLUMINATION_ENGINE_LOG_LEVEL_WARN
-        );
+    frameGraph->runAndWait();
     currentFrame = (currentFrame + 1) % (int) swapchain.image_count;
     if (frameTime > 1.0 / 30.0) {
         settings->logger.log(
-          "Frame #" + std::to_string(frameNumber) + " took " + std::to_string(frameTime * 1000) + "ms to compute.",
+          "Frame #" + std::to_string(frameNumber) + " took " + std::to_string(frameTime * 1000) +
+            "ms to compute. Stages of the latest frame:\n" + frameGraph->timingReport(),
           IE::Core::Logger::ILLUMINATION_ENGINE_LOG_LEVEL_WARN
         );
     }
@@ -561,6 +551,98 @@ bool IERenderEngine::_vulkanUpdate() {
     return glfwWindowShouldClose(window) == 0;
 }
 
+void IERenderEngine::createFrameGraph() {
+    using IE::Core::Threading::IE_THREAD_TYPE_MAIN_THREAD;
+    using IE::Core::Threading::IE_THREAD_TYPE_WORKER_THREAD;
+    frameGraph = std::make_unique<IE::Core::Threading::TaskGraph>(IE::Core::Core::getThreadPool());
+    IE::Core::Threading::TaskGraph::NodeID acquire = frameGraph->addNode(
+      "Acquire image",
+      [this] {
+          vkWaitForFences(device.device, 1, &inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
+          VkResult result = vkAcquireNextImageKhr(
+            device.device,
+            swapchain.swapchain,
+            UINT64_MAX,
+            imageAvailableSemaphores[currentFrame],
+            VK_NULL_HANDLE,
+            &frameImageIndex
+          );
+          if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) handleResolutionChange();
+          if (imagesInFlight[frameImageIndex] != VK_NULL_HANDLE)
+              vkWaitForFences(device.device, 1, &imagesInFlight[frameImageIndex], VK_TRUE, UINT64_MAX);
+          imagesInFlight[frameImageIndex] = inFlightFences[currentFrame];
+      },
+      IE_THREAD_TYPE_MAIN_THREAD
+    );
+    // The resolution only changes between frames, so the camera can be updated while the image is acquired.
+    IE::Core::Threading::TaskGraph::NodeID cameraUpdate =
+      frameGraph->addNode("Camera", [this] { camera.update(); }, IE_THREAD_TYPE_WORKER_THREAD);
+    IE::Core::Threading::TaskGraph::NodeID record = frameGraph->addNode(
+      "Record",
+      [this] {
+          VkViewport viewport{
+            .x        = 0.0F,
+            .y        = 0.0F,
+            .width    = (float) swapchain.extent.width,
+            .height   = (float) swapchain.extent.height,
+            .minDepth = 0.0F,
+            .maxDepth = 1.0F};
+          graphicsCommandPool->index(frameImageIndex)->recordSetViewport(0, 1, &viewport);
+          VkRect2D scissor{
+            .offset = {0, 0},
+            .extent = swapchain.extent,
+          };
+          graphicsCommandPool->index(frameImageIndex)->recordSetScissor(0, 1, &scissor);
+          IERenderPassBeginInfo renderPassBeginInfo = renderPass->beginRenderPass(frameImageIndex);
+          graphicsCommandPool->index(frameImageIndex)
+            ->recordBeginRenderPass(&renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+          for (const std::weak_ptr<IERenderable> &renderable : renderables)
+              renderable.lock()->update(frameImageIndex);
+          graphicsCommandPool->index(frameImageIndex)->recordEndRenderPass();
+      },
+      IE_THREAD_TYPE_WORKER_THREAD
+    );
+    IE::Core::Threading::TaskGraph::NodeID submit = frameGraph->addNode(
+      "Submit",
+      [this] {
+          graphicsCommandPool->index(frameImageIndex)
+            ->execute(
+              imageAvailableSemaphores[currentFrame],
+              renderFinishedSemaphores[currentFrame],
+              inFlightFences[currentFrame]
+            );
+      },
+      IE_THREAD_TYPE_MAIN_THREAD
+    );
+    IE::Core::Threading::TaskGraph::NodeID present = frameGraph->addNode(
+      "Present",
+      [this] {
+          VkPresentInfoKHR presentInfo{
+            .sType              = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
+            .waitSemaphoreCount = 1,
+            .pWaitSemaphores    = &renderFinishedSemaphores[currentFrame],
+            .swapchainCount     = 1,
+            .pSwapchains        = &swapchain.swapchain,
+            .pImageIndices      = &frameImageIndex,
+          };
+          graphicsCommandPool->index(frameImageIndex)->commandPool->commandPoolMutex.lock();
+          VkResult result = vkQueuePresentKHR(presentQueue, &presentInfo);
+          graphicsCommandPool->index(frameImageIndex)->commandPool->commandPoolMutex.unlock();
+          if (result != VK_SUCCESS && result != VK_ERROR_OUT_OF_DATE_KHR)
+              settings->logger.log(
+                "Failed to present image! Error: " + translateVkResultCodes(result),
+                IE::Core::Logger::ILLUMINATION_ENGINE_LOG_LEVEL_WARN
+              );
+      },
+      IE_THREAD_TYPE_MAIN_THREAD
+    );
+    frameGraph->addDependency(record, acquire);
+    frameGraph->addDependency(record, cameraUpdate);
+    frameGraph->addDependency(submit, record);
+    frameGraph->addDependency(present, submit);
+    frameGraph->compile();
+}
+
 void IERenderEngine::toggleFullscreen() {
     settings->fullscreen ^= true;
     if (settings->fullscreen) {
@@ -735,6 +817,8 @@ bool IERenderEngine::ExtensionAndFeatureInfo::variableDescriptorCountSupportQuer
 }
 
 IERenderEngine::IERenderEngine(IESettings &t_settings) : settings(new IESettings{t_settings}) {
+    if (settings->traceFrames > 0) IE::Core::Threading::Tracer::start();
+
     // Initialize GLFW then create and setup window
     /**@todo Clean up this section of the code as it is still quite messy. Optimally this would be done with a GUI
      * abstraction.*/
@@ -14,6 +14,7 @@ struct GLFWmonitor;
 #include "CommandBuffer/IECommandPool.hpp"
 #include "Core/AssetModule/IEAsset.hpp"
 #include "Core/EngineModule/Engine.hpp"
+#include "Core/ThreadingModule/TaskGraph.hpp"
 #include "GraphicsModule/RenderPass/IEFramebuffer.hpp"
 #include "GraphicsModule/RenderPass/IERenderPass.hpp"
 #include "IEAPI.hpp"
@@ -28,6 +29,8 @@ struct GLFWmonitor;
 
 // System dependencies
 #include <algorithm>
+#include <chrono>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -243,6 +246,10 @@ public:
     std::vector<std::shared_ptr<IETexture>>        textures{};
     std::vector<VkImageView>                       swapchainImageViews{};
     std::vector<std::weak_ptr<IERenderable>>       renderables{};
+    /// The number of frames between thread pool statistics reports, in builds that collect them.
+    static constexpr int                           THREADING_STATISTICS_INTERVAL{600};
+    /// The most time each frame that may be spent on other main thread work, such as uploads.
+    static constexpr std::chrono::microseconds     MAIN_THREAD_BUDGET{2000};
     float                                          frameTime{};
     int                                            frameNumber{};
     // global depth image used by all framebuffers. Should this be here?
@@ -252,21 +259,35 @@ public:
 
     explicit IERenderEngine(IESettings &settings);
 
+    /** Render a frame. The scratch memory that it allocates on the calling thread is freed once it returns. */
     bool update();
 
+    /**
+     * @brief Write everything that the tracer has recorded to traces/ in the file system's base directory.
+     * @details Nothing is recorded until IE::Core::Threading::Tracer::start() is called. If
+     * IESettings::traceFrames is set, recording starts with the engine, and this is called once that many frames
+     * have been rendered.
+     * @return False if the trace could not be written.
+     */
+    bool writeTrace();
+
 private:
-    std::vector<VkFence>               inFlightFences{};
-    std::vector<VkFence>               imagesInFlight{};
-    std::vector<VkSemaphore>           imageAvailableSemaphores{};
-    std::vector<VkSemaphore>           renderFinishedSemaphores{};
-    std::vector<std::function<void()>> fullRecreationDeletionQueue{};
-    std::vector<std::function<void()>> recreationDeletionQueue{};
-    std::vector<std::function<void()>> renderableDeletionQueue{};
-    std::vector<std::function<void()>> deletionQueue{};
-    size_t                             currentFrame{};
-    bool                               framebufferResized{settings->fullscreen};
-    float                              previousTime{};
-    bool                               shouldBeFullscreen{settings->fullscreen};
+    std::vector<VkFence>                            inFlightFences{};
+    std::vector<VkFence>                            imagesInFlight{};
+    std::vector<VkSemaphore>                        imageAvailableSemaphores{};
+    std::vector<VkSemaphore>                        renderFinishedSemaphores{};
+    std::vector<std::function<void()>>              fullRecreationDeletionQueue{};
+    std::vector<std::function<void()>>              recreationDeletionQueue{};
+    std::vector<std::function<void()>>              renderableDeletionQueue{};
+    std::vector<std::function<void()>>              deletionQueue{};
+    size_t                                          currentFrame{};
+    bool                                            framebufferResized{settings->fullscreen};
+    float                                           previousTime{};
+    bool                                            shouldBeFullscreen{settings->fullscreen};
+    // The stages of a Vulkan frame, declared once and run every frame.
+    std::unique_ptr<IE::Core::Threading::TaskGraph> frameGraph{};
+    // The swapchain image that the frame graph is rendering to.
+    uint32_t                                        frameImageIndex{};
 
 
     static std::function<bool(IERenderEngine &)> _update;
@@ -289,6 +310,16 @@ private:
 
     void createRenderPass();
 
+    /**
+     * @brief Declare the stages of a Vulkan frame in frameGraph.
+     * @details Acquiring the image, updating the camera, recording, submitting and presenting run as one node
+     * each. Acquiring, submitting and presenting stay on the main thread, as they use the window and the queues.
+     * The camera is updated on a worker while the image is acquired, and recording follows on a worker once both
+     * are done, which is safe as the command pool is locked while recording and the main thread runs nothing else
+     * while it waits for the frame.
+     */
+    void createFrameGraph();
+
     void handleResolutionChange();
 
     static void windowPositionCallback(GLFWwindow *pWindow, int x, int y);
@@ -18,6 +18,7 @@
 
 // System dependencies
 #include <array>
+#include <cstdlib>
 #include <GLFW/glfw3.h>
 #include <string>
 
@@ -36,6 +37,7 @@ public:
         fullscreenPosition = {0, 0};
         windowedPosition   = {defaultPosition};
         currentPosition    = fullscreen ? &fullscreenPosition : &windowedPosition;
+        if (const char *frames = std::getenv("IE_TRACE_FRAMES")) traceFrames = std::atoi(frames);
     }
 
     IE::Core::Logger    logger{"Graphics Logger"};
@@ -64,4 +66,6 @@ public:
     double              renderDistance{1000000};
     double              mouseSensitivity{0.1};
     float               movementSpeed{2.5};
+    // Trace this many frames from startup, then write the trace to traces/. Defaults to $IE_TRACE_FRAMES, or 0.
+    int                 traceFrames{0};
 };
\ No newline at end of file
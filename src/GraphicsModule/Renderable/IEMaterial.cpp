@@ -3,6 +3,7 @@
 #include "IEMesh.hpp"
 #include "IERenderEngine.hpp"
 
+#include <algorithm>
 #include <memory>
 
 IEMaterial::IEMaterial(IERenderEngine *engineLink) {
@@ -38,14 +39,7 @@ void IEMaterial::_openglCreate() {
 void IEMaterial::_vulkanCreate() {
 }
 
-std::function<void(IEMaterial &, const std::string &, const aiScene *, uint32_t)> IEMaterial::_loadFromDiskToRAM{
-  nullptr};
-
-void IEMaterial::loadFromDiskToRAM(const std::string &directory, const aiScene *scene, uint32_t index) {
-    _loadFromDiskToRAM(*this, directory, scene, index);
-}
-
-void IEMaterial::_openglLoadFromDiskToRAM(const std::string &directory, const aiScene *scene, uint32_t index) {
+void IEMaterial::findTextures(const aiScene *scene, uint32_t index) {
     aiMaterial *material = scene->mMaterials[index];
 
     // find all textures in scene including embedded textures
@@ -58,67 +52,84 @@ void IEMaterial::_openglLoadFromDiskToRAM(const std::string &directory, const ai
             supportedTextureTypes.erase(supportedTextureTypes.begin() + i--);  // Remove any unused texture types
         textureCount += thisCount;
     }
-    linkedRenderEngine->textures.reserve(linkedRenderEngine->textures.size() + textureCount);
 
-    aiString              texturePath{};
-    std::string           data{};
-    aiTexture            *texture;
-    uint32_t              textureIndex{0};
-    IETexture::CreateInfo imageCreateInfo{};
+    aiString         texturePath{};
+    const aiTexture *texture;
+    uint32_t         textureIndex{0};
+    textureBindings.clear();
 
-    // load all textures despite embedded state
+    // find all textures despite embedded state
     for (std::pair<uint32_t *, aiTextureType> textureType : supportedTextureTypes) {
         while (texturePath.length == 0 && textureIndex < textureCount)
             material->GetTexture(textureType.second, textureIndex++, &texturePath);
-        texture = const_cast<aiTexture *>(scene->GetEmbeddedTexture(texturePath.C_Str()));
-        if (texture == nullptr || texture->mHeight != 0) {  // is the texture not an embedded texture?
-            texture = new aiTexture;
-            texture->mFilename =
-              directory.substr(0, directory.find_last_of('/')) + "/textures/" + texturePath.C_Str();
-            texture->mHeight = 1;  // flag texture as not embedded
+        TextureBinding &binding = textureBindings.emplace_back(TextureBinding{.type = textureType.second});
+        texture                 = scene->GetEmbeddedTexture(texturePath.C_Str());
+        if (texture == nullptr || texture->mHeight != 0)  // is the texture not an embedded texture?
+            binding.path = texturePath.C_Str();
+        else {
+            const auto *data = reinterpret_cast<const char *>(texture->pcData);
+            binding.embeddedData.assign(data, data + texture->mWidth);
         }
-        *textureType.first = linkedRenderEngine->textures.size();
-
-        linkedRenderEngine->textures.push_back(std::make_shared<IETexture>(linkedRenderEngine, &imageCreateInfo));
-        linkedRenderEngine->textures[*textureType.first]->uploadToRAM(texture);
     }
 }
 
-void IEMaterial::_vulkanLoadFromDiskToRAM(const std::string &directory, const aiScene *scene, uint32_t index) {
-    aiMaterial *material = scene->mMaterials[index];
+std::function<void(IEMaterial &)> IEMaterial::_loadFromDiskToRAM{nullptr};
 
-    // find all textures in scene including embedded textures
-    textureCount = 0;
-    uint32_t thisCount;
-    /**@todo Build a system that tracks duplicate textures and only keeps one copy in memory.*/
-    for (size_t i = 0; i < supportedTextureTypes.size(); ++i) {
-        thisCount = material->GetTextureCount(supportedTextureTypes[i].second);
-        if (thisCount == 0) supportedTextureTypes.erase(supportedTextureTypes.begin() + i--);
-        textureCount += thisCount;
+void IEMaterial::loadFromDiskToRAM() {
+    // Materials read back from a cache start out supporting every texture type, so drop the ones not in use.
+    std::erase_if(supportedTextureTypes, [&](const std::pair<uint32_t *, aiTextureType> &textureType) {
+        return std::none_of(textureBindings.begin(), textureBindings.end(), [&](const TextureBinding &binding) {
+            return binding.type == textureType.second;
+        });
+    });
+    _loadFromDiskToRAM(*this);
+}
+
+void IEMaterial::_openglLoadFromDiskToRAM() {
+    linkedRenderEngine->textures.reserve(linkedRenderEngine->textures.size() + textureBindings.size());
+
+    IETexture::CreateInfo imageCreateInfo{};
+
+    // load all textures despite embedded state
+    for (const TextureBinding &binding : textureBindings) {
+        aiTexture texture{};
+        if (binding.embeddedData.empty()) {
+            texture.mFilename.Set(binding.path);
+            texture.mHeight = 1;  // flag texture as not embedded
+        } else {
+            texture.mWidth = static_cast<unsigned int>(binding.embeddedData.size());
+            texture.pcData = reinterpret_cast<aiTexel *>(const_cast<char *>(binding.embeddedData.data()));
+        }
+        for (std::pair<uint32_t *, aiTextureType> textureType : supportedTextureTypes)
+            if (textureType.second == binding.type) *textureType.first = linkedRenderEngine->textures.size();
+
+        linkedRenderEngine->textures.push_back(std::make_shared<IETexture>(linkedRenderEngine, &imageCreateInfo));
+        linkedRenderEngine->textures.back()->uploadToRAM(&texture);
+        texture.pcData = nullptr;  // The data belongs to the binding, so must not be freed with the texture.
     }
-    linkedRenderEngine->textures.reserve(linkedRenderEngine->textures.size() + textureCount);
+}
+
+void IEMaterial::_vulkanLoadFromDiskToRAM() {
+    linkedRenderEngine->textures.reserve(linkedRenderEngine->textures.size() + textureBindings.size());
 
-    aiString              texturePath{};
-    std::string           data{};
-    aiTexture            *texture;
-    uint32_t              textureIndex{0};
     IETexture::CreateInfo imageCreateInfo{};
 
     // load all textures despite embedded state
-    for (std::pair<uint32_t *, aiTextureType> textureType : supportedTextureTypes) {
-        while (texturePath.length == 0 && textureIndex < textureCount)
-            material->GetTexture(textureType.second, textureIndex++, &texturePath);
-        texture = const_cast<aiTexture *>(scene->GetEmbeddedTexture(texturePath.C_Str()));
-        if (texture == nullptr || texture->mHeight != 0) {  // is the texture not an embedded texture?
-            texture = new aiTexture;
-            texture->mFilename =
-              directory.substr(0, directory.find_last_of('/')) + "/textures/" + texturePath.C_Str();
-            texture->mHeight = 1;  // flag texture as not embedded
+    for (const TextureBinding &binding : textureBindings) {
+        aiTexture texture{};
+        if (binding.embeddedData.empty()) {
+            texture.mFilename.Set(binding.path);
+            texture.mHeight = 1;  // flag texture as not embedded
+        } else {
+            texture.mWidth = static_cast<unsigned int>(binding.embeddedData.size());
+            texture.pcData = reinterpret_cast<aiTexel *>(const_cast<char *>(binding.embeddedData.data()));
         }
-        *textureType.first = linkedRenderEngine->textures.size();
+        for (std::pair<uint32_t *, aiTextureType> textureType : supportedTextureTypes)
+            if (textureType.second == binding.type) *textureType.first = linkedRenderEngine->textures.size();
 
         linkedRenderEngine->textures.push_back(std::make_shared<IETexture>(linkedRenderEngine, &imageCreateInfo));
-        linkedRenderEngine->textures[*textureType.first]->uploadToRAM(texture);
+        linkedRenderEngine->textures.back()->uploadToRAM(&texture);
+        texture.pcData = nullptr;  // The data belongs to the binding, so must not be freed with the texture.
     }
 }
 
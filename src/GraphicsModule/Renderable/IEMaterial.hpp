@@ -9,6 +9,7 @@
 #include <iostream>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #define GLM_FORCE_RADIANS
 
@@ -18,10 +19,18 @@ class IEMesh;
 
 class IEMaterial {
 public:
-    uint32_t        textureCount{};
-    uint32_t        diffuseTextureIndex{};
-    glm::vec4       diffuseColor{1.0F, 1.0F, 1.0F, 1.0F};
-    IERenderEngine *linkedRenderEngine{};
+    /** A texture that a material uses, as found in a scene. */
+    struct TextureBinding {
+        aiTextureType     type;
+        std::string       path;          // Only used if embeddedData is empty. See findTextures().
+        std::vector<char> embeddedData;  // The compressed image, for textures embedded in the scene.
+    };
+
+    uint32_t                    textureCount{};
+    uint32_t                    diffuseTextureIndex{};
+    glm::vec4                   diffuseColor{1.0F, 1.0F, 1.0F, 1.0F};
+    IERenderEngine             *linkedRenderEngine{};
+    std::vector<TextureBinding> textureBindings{};
 
     IEMaterial() = default;
 
@@ -39,13 +48,21 @@ public:
     void _vulkanCreate();
 
 
-    static std::function<void(IEMaterial &, const std::string &, const aiScene *, uint32_t)> _loadFromDiskToRAM;
+    /**
+     * @brief Find the textures that a material of a scene uses, filling textureBindings for loadFromDiskToRAM().
+     * @details Paths are left as the scene gives them, relative to the textures directory next to the model.
+     */
+    void findTextures(const aiScene *, uint32_t);
+
+
+    static std::function<void(IEMaterial &)> _loadFromDiskToRAM;
 
-    void loadFromDiskToRAM(const std::string &, const aiScene *, uint32_t);
+    /** Load the textures in textureBindings. */
+    void loadFromDiskToRAM();
 
-    void _openglLoadFromDiskToRAM(const std::string &, const aiScene *, uint32_t);
+    void _openglLoadFromDiskToRAM();
 
-    void _vulkanLoadFromDiskToRAM(const std::string &, const aiScene *, uint32_t);
+    void _vulkanLoadFromDiskToRAM();
 
 
     static std::function<void(IEMaterial &)> _loadFromRAMToVRAM;
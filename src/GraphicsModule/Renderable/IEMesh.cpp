@@ -36,46 +36,38 @@ void IEMesh::create(IERenderEngine *engineLink) {
     material->create(linkedRenderEngine);
 }
 
-std::function<void(IEMesh &, const std::string &, const aiScene *, aiMesh *)> IEMesh::_loadFromDiskToRAM{nullptr};
-
-void IEMesh::loadFromDiskToRAM(const std::string &directory, const aiScene *scene, aiMesh *mesh) {
-    _loadFromDiskToRAM(*this, directory, scene, mesh);
-}
-
-void IEMesh::_openglLoadFromDiskToRAM(const std::string &directory, const aiScene *scene, aiMesh *mesh) {
-    // record indices
-    vertices.reserve(mesh->mNumVertices);
-    IEVertex temporaryVertex{};
-    for (size_t i = 0; i < mesh->mNumVertices; ++i) {
+void IEMesh::loadVertices(aiMesh *mesh) {
+    vertices.resize(mesh->mNumVertices);
+    // Every vertex is converted independently, so large meshes are converted on all of the worker threads.
+    IE::Core::Threading::ThreadPool *threadPool = IE::Core::Core::getThreadPool();
+    auto conversion = threadPool->parallelFor(0, vertices.size(), VERTEX_GRAIN_SIZE, [this, mesh](size_t i) {
+        IEVertex &vertex = vertices[i];
         if (mesh->HasPositions())
-            temporaryVertex.position = {mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z};
-        if (mesh->HasNormals())
-            temporaryVertex.normal = {mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z};
+            vertex.position = {mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z};
+        if (mesh->HasNormals()) vertex.normal = {mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z};
         if (mesh->HasTextureCoords(0))
-            temporaryVertex.textureCoordinates = {mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y};
+            vertex.textureCoordinates = {mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y};
         if (mesh->HasVertexColors(0)) {
-            temporaryVertex.color =
+            vertex.color =
               {mesh->mColors[0][i].a, mesh->mColors[0][i].r, mesh->mColors[0][i].g, mesh->mColors[0][i].b};
         }
         if (mesh->HasTangentsAndBitangents()) {
-            temporaryVertex.tangent   = {mesh->mTangents[i].x, mesh->mTangents[i].y, mesh->mTangents[i].z};
-            temporaryVertex.biTangent = {mesh->mBitangents[i].x, mesh->mBitangents[i].y, mesh->mBitangents[i].z};
+            vertex.tangent   = {mesh->mTangents[i].x, mesh->mTangents[i].y, mesh->mTangents[i].z};
+            vertex.biTangent = {mesh->mBitangents[i].x, mesh->mBitangents[i].y, mesh->mBitangents[i].z};
         }
-        vertices.push_back(temporaryVertex);
-    }
+    });
+    IE::Core::Threading::Worker::waitForTask(threadPool, *conversion);
+}
 
-    // Create vertex buffer.
-    IEBuffer::CreateInfo vertexBufferCreateInfo{
-      .size = sizeof(vertices[0]) * vertices.size(),
-      .type = GL_ARRAY_BUFFER,
-    };
-    vertexBuffer->create(linkedRenderEngine, &vertexBufferCreateInfo);
-    vertexBuffer->uploadToRAM(vertices.data(), vertexBufferCreateInfo.size);
+void IEMesh::loadFromScene(const aiScene *scene, aiMesh *mesh) {
+    // record indices
+    loadVertices(mesh);
 
     // assuming all faces are triangles
     triangleCount = mesh->mNumFaces;
 
     // record vertices
+    indices.clear();
     indices.reserve(3UL * triangleCount);
     size_t j;
     for (size_t i = 0; i < triangleCount; ++i) {
@@ -89,6 +81,25 @@ void IEMesh::_openglLoadFromDiskToRAM(const std::string &directory, const aiScen
         for (j = 0; j < mesh->mFaces[i].mNumIndices; ++j) indices.push_back(mesh->mFaces[i].mIndices[j]);
     }
 
+    // find material
+    material->findTextures(scene, mesh->mMaterialIndex);
+}
+
+std::function<void(IEMesh &)> IEMesh::_loadFromDiskToRAM{nullptr};
+
+void IEMesh::loadFromDiskToRAM() {
+    _loadFromDiskToRAM(*this);
+}
+
+void IEMesh::_openglLoadFromDiskToRAM() {
+    // Create vertex buffer.
+    IEBuffer::CreateInfo vertexBufferCreateInfo{
+      .size = sizeof(vertices[0]) * vertices.size(),
+      .type = GL_ARRAY_BUFFER,
+    };
+    vertexBuffer->create(linkedRenderEngine, &vertexBufferCreateInfo);
+    vertexBuffer->uploadToRAM(vertices.data(), vertexBufferCreateInfo.size);
+
     // Create index buffer
     IEBuffer::CreateInfo indexBufferCreateInfo{
       .size = sizeof(indices[0]) * indices.size(),
@@ -98,31 +109,10 @@ void IEMesh::_openglLoadFromDiskToRAM(const std::string &directory, const aiScen
     indexBuffer->uploadToRAM(indices.data(), indexBufferCreateInfo.size);
 
     // load material
-    material->loadFromDiskToRAM(directory, scene, mesh->mMaterialIndex);
+    material->loadFromDiskToRAM();
 }
 
-void IEMesh::_vulkanLoadFromDiskToRAM(const std::string &directory, const aiScene *scene, aiMesh *mesh) {
-    // record indices
-    vertices.reserve(mesh->mNumVertices);
-    IEVertex temporaryVertex{};
-    for (size_t i = 0; i < mesh->mNumVertices; ++i) {
-        if (mesh->HasPositions())
-            temporaryVertex.position = {mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z};
-        if (mesh->HasNormals())
-            temporaryVertex.normal = {mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z};
-        if (mesh->HasTextureCoords(0))
-            temporaryVertex.textureCoordinates = {mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y};
-        if (mesh->HasVertexColors(0)) {
-            temporaryVertex.color =
-              {mesh->mColors[0][i].a, mesh->mColors[0][i].r, mesh->mColors[0][i].g, mesh->mColors[0][i].b};
-        }
-        if (mesh->HasTangentsAndBitangents()) {
-            temporaryVertex.tangent   = {mesh->mTangents[i].x, mesh->mTangents[i].y, mesh->mTangents[i].z};
-            temporaryVertex.biTangent = {mesh->mBitangents[i].x, mesh->mBitangents[i].y, mesh->mBitangents[i].z};
-        }
-        vertices.push_back(temporaryVertex);
-    }
-
+void IEMesh::_vulkanLoadFromDiskToRAM() {
     // Create vertex buffer.
     IEBuffer::CreateInfo vertexBufferCreateInfo{
       .size            = sizeof(vertices[0]) * vertices.size(),
@@ -132,23 +122,6 @@ void IEMesh::_vulkanLoadFromDiskToRAM(const std::string &directory, const aiScen
     vertexBuffer->create(linkedRenderEngine, &vertexBufferCreateInfo);
     vertexBuffer->uploadToRAM(vertices.data(), vertexBufferCreateInfo.size);
 
-    // assuming all faces are triangles
-    triangleCount = mesh->mNumFaces;
-
-    // record vertices
-    indices.reserve(3UL * triangleCount);
-    size_t j;
-    for (size_t i = 0; i < triangleCount; ++i) {
-        if (mesh->mFaces[i].mNumIndices != 3) {
-            linkedRenderEngine->settings->logger.log(
-
-              "Attempted to add a non-triangular face to a mesh! Try using the aiProcess_Triangulate flag.",
-              IE::Core::Logger::ILLUMINATION_ENGINE_LOG_LEVEL_WARN
-            );
-        }
-        for (j = 0; j < mesh->mFaces[i].mNumIndices; ++j) indices.push_back(mesh->mFaces[i].mIndices[j]);
-    }
-
     // Create index buffer
     IEBuffer::CreateInfo indexBufferCreateInfo{
       .size            = sizeof(indices[0]) * indices.size(),
@@ -159,7 +132,7 @@ void IEMesh::_vulkanLoadFromDiskToRAM(const std::string &directory, const aiScen
     indexBuffer->uploadToRAM(indices.data(), indexBufferCreateInfo.size);
 
     // load material
-    material->loadFromDiskToRAM(directory, scene, mesh->mMaterialIndex);
+    material->loadFromDiskToRAM();
 
     // create descriptor set
     IEDescriptorSet::CreateInfo descriptorSetCreateInfo{
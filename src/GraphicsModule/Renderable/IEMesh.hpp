@@ -22,14 +22,24 @@ public:
 
     void create(IERenderEngine *);
 
+    /// The smallest number of vertices that loadVertices() converts in one task.
+    static constexpr size_t VERTEX_GRAIN_SIZE{16384};
 
-    static std::function<void(IEMesh &, const std::string &, const aiScene *, aiMesh *)> _loadFromDiskToRAM;
+    /** Convert the vertices of an Assimp mesh into this mesh's vertex array. */
+    void loadVertices(aiMesh *);
 
-    void loadFromDiskToRAM(const std::string &, const aiScene *, aiMesh *);
+    /** Read the vertices, indices and textures of an Assimp mesh, ready for loadFromDiskToRAM(). */
+    void loadFromScene(const aiScene *, aiMesh *);
 
-    void _openglLoadFromDiskToRAM(const std::string &, const aiScene *, aiMesh *);
 
-    void _vulkanLoadFromDiskToRAM(const std::string &, const aiScene *, aiMesh *);
+    static std::function<void(IEMesh &)> _loadFromDiskToRAM;
+
+    /** Create the buffers and material of this mesh from its vertices, indices and textures. */
+    void loadFromDiskToRAM();
+
+    void _openglLoadFromDiskToRAM();
+
+    void _vulkanLoadFromDiskToRAM();
 
 
     static std::function<void(IEMesh &)> _loadFromRAMToVRAM;
@@ -5,6 +5,12 @@
 #include "IEMesh.hpp"
 #include "IERenderEngine.hpp"
 
+/* Include dependencies from other modules. */
+#include "Core/Core.hpp"
+#include "Core/FileSystemModule/File.hpp"
+#include "Core/FileSystemModule/FileSystem.hpp"
+#include "Core/FileSystemModule/Importer.hpp"
+
 /* Include external dependencies. */
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
@@ -14,6 +20,40 @@
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtx/euler_angles.hpp>
 
+/* Include system dependencies. */
+#include <cstring>
+#include <type_traits>
+
+namespace {
+/// The first bytes of a cached model. All integers in a cached model are stored in the byte order of the host.
+constexpr char MODEL_CACHE_MAGIC[4]{'I', 'E', 'M', 'C'};
+
+static_assert(std::is_trivially_copyable_v<IEVertex>, "vertices are cached as raw bytes");
+
+void writeBytes(std::vector<std::byte> &data, const void *bytes, size_t size) {
+    const auto *begin = static_cast<const std::byte *>(bytes);
+    data.insert(data.end(), begin, begin + size);
+}
+
+template<typename T>
+void writeValue(std::vector<std::byte> &data, const T &value) {
+    writeBytes(data, &value, sizeof(value));
+}
+
+/** Read size bytes from the front of data, or fail without reading anything if there are not that many left. */
+bool readBytes(std::span<const std::byte> &data, void *bytes, size_t size) {
+    if (size > data.size()) return false;
+    if (size > 0) std::memcpy(bytes, data.data(), size);
+    data = data.subspan(size);
+    return true;
+}
+
+template<typename T>
+bool readValue(std::span<const std::byte> &data, T &value) {
+    return readBytes(data, &value, sizeof(value));
+}
+}  // namespace
+
 IERenderable::IERenderable(IERenderEngine *engineLink, const std::string &filePath) {
     create(engineLink, filePath);
 }
@@ -82,16 +122,7 @@ void IERenderable::loadFromDiskToRAM() {
 }
 
 void IERenderable::_openglLoadFromDiskToRAM() {
-    // Read input file
-    const aiScene *scene = importer.ReadFile(
-      directory + modelName,
-      aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_OptimizeMeshes | aiProcess_RemoveRedundantMaterials |
-        aiProcess_JoinIdenticalVertices | aiProcess_PreTransformVertices | aiProcess_SortByPType |
-        aiProcess_GenUVCoords | aiProcess_GenNormals | aiProcess_ValidateDataStructure |
-        aiProcess_ImproveCacheLocality | aiProcess_FixInfacingNormals | aiProcess_FindDegenerates |
-        aiProcess_FindInvalidData | aiProcess_FindInstances | aiProcess_Debone
-    );
-    if ((scene == nullptr) || ((scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE) != 0U) || (scene->mRootNode == nullptr)) {
+    if (!loadMeshes()) {
         linkedRenderEngine->settings->logger.log(
           "Failed to prepare scene from file: " + std::string(directory + modelName) +
             "\t\tError: " + importer.GetErrorString(),
@@ -99,29 +130,13 @@ void IERenderable::_openglLoadFromDiskToRAM() {
         );
     }
 
-    meshes.resize(scene->mNumMeshes);
-    uint32_t meshIndex = 0;
-
-    // import all meshes
-    for (IEMesh &mesh : meshes) {
-        mesh.create(linkedRenderEngine);
-        mesh.loadFromDiskToRAM(directory, scene, scene->mMeshes[meshIndex++]);
-    }
+    for (IEMesh &mesh : meshes) mesh.loadFromDiskToRAM();
 
     modelBuffer.uploadToRAM(std::vector<char>{sizeof(glm::mat4)});
 }
 
 void IERenderable::_vulkanLoadFromDiskToRAM() {
-    // Read input file
-    const aiScene *scene = importer.ReadFile(
-      directory + modelName,
-      aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_OptimizeMeshes | aiProcess_RemoveRedundantMaterials |
-        aiProcess_JoinIdenticalVertices | aiProcess_PreTransformVertices | aiProcess_SortByPType |
-        aiProcess_GenUVCoords | aiProcess_GenNormals | aiProcess_ValidateDataStructure |
-        aiProcess_ImproveCacheLocality | aiProcess_FixInfacingNormals | aiProcess_FindDegenerates |
-        aiProcess_FindInvalidData | aiProcess_FindInstances | aiProcess_Debone
-    );
-    if ((scene == nullptr) || ((scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE) != 0U) || (scene->mRootNode == nullptr)) {
+    if (!loadMeshes()) {
         linkedRenderEngine->settings->logger.log(
           "Failed to prepare scene from file: " + std::string(directory + modelName) +
             "\t\tError: " + importer.GetErrorString(),
@@ -129,16 +144,118 @@ void IERenderable::_vulkanLoadFromDiskToRAM() {
         );
     }
 
+    for (IEMesh &mesh : meshes) mesh.loadFromDiskToRAM();
+
+    modelBuffer.uploadToRAM(std::vector<char>{sizeof(glm::mat4)});
+}
+
+bool IERenderable::loadMeshes() {
+    IE::Core::FileSystem                *fileSystem = IE::Core::Core::getFileSystem();
+    IE::Core::FileSystem::DerivedDataKey key{
+      .contentHash = fileSystem->getContentHash(directory + modelName),
+      .parameters  = IMPORT_FLAGS,
+      .version     = CACHE_VERSION,
+    };
+    if (key.contentHash != 0) {
+        if (readMeshes(fileSystem->loadDerivedData(key).bytes())) {
+            resolveTexturePaths();
+            return true;
+        }
+        meshes.clear();
+    }
+
+    // Read input file, and any it refers to, through the file system so that mounted packs are used.
+    IE::Core::File *file = fileSystem->getFile(directory + modelName);
+    if (file == nullptr) return false;
+    const aiScene *scene = IE::Core::Importer::readScene(importer, *file, IMPORT_FLAGS, fileSystem);
+    if ((scene == nullptr) || ((scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE) != 0U) || (scene->mRootNode == nullptr))
+        return false;
+
     meshes.resize(scene->mNumMeshes);
     uint32_t meshIndex = 0;
 
     // import all meshes
     for (IEMesh &mesh : meshes) {
         mesh.create(linkedRenderEngine);
-        mesh.loadFromDiskToRAM(directory, scene, scene->mMeshes[meshIndex++]);
+        mesh.loadFromScene(scene, scene->mMeshes[meshIndex++]);
     }
+    // Everything needed has been copied out of the scene.
+    importer.FreeScene();
 
-    modelBuffer.uploadToRAM(std::vector<char>{sizeof(glm::mat4)});
+    if (key.contentHash != 0) fileSystem->storeDerivedData(key, writeMeshes());
+    resolveTexturePaths();
+    return true;
+}
+
+void IERenderable::resolveTexturePaths() {
+    std::string textureDirectory = directory.substr(0, directory.find_last_of('/')) + "/textures/";
+    for (IEMesh &mesh : meshes)
+        for (IEMaterial::TextureBinding &binding : mesh.material->textureBindings)
+            if (binding.embeddedData.empty()) binding.path.insert(0, textureDirectory);
+}
+
+bool IERenderable::readMeshes(std::span<const std::byte> data) {
+    char     magic[sizeof(MODEL_CACHE_MAGIC)];
+    uint32_t meshCount;
+    if (!readValue(data, magic) || std::memcmp(magic, MODEL_CACHE_MAGIC, sizeof(magic)) != 0) return false;
+    // Every count is checked against the bytes left before anything is allocated for it.
+    if (!readValue(data, meshCount) || meshCount > data.size()) return false;
+
+    meshes.resize(meshCount);
+    for (IEMesh &mesh : meshes) {
+        uint64_t vertexCount;
+        uint64_t indexCount;
+        uint32_t bindingCount;
+        mesh.create(linkedRenderEngine);
+        if (!readValue(data, vertexCount) || !readValue(data, indexCount) ||
+            !readValue(data, mesh.triangleCount) || !readValue(data, bindingCount))
+            return false;
+        if (vertexCount > data.size() / sizeof(IEVertex) || indexCount > data.size() / sizeof(uint32_t))
+            return false;
+        mesh.vertices.resize(vertexCount);
+        mesh.indices.resize(indexCount);
+        if (!readBytes(data, mesh.vertices.data(), vertexCount * sizeof(IEVertex)) ||
+            !readBytes(data, mesh.indices.data(), indexCount * sizeof(uint32_t)) || bindingCount > data.size())
+            return false;
+
+        mesh.material->textureBindings.resize(bindingCount);
+        for (IEMaterial::TextureBinding &binding : mesh.material->textureBindings) {
+            uint32_t type;
+            uint32_t pathLength;
+            uint64_t embeddedSize;
+            if (!readValue(data, type) || !readValue(data, pathLength) || !readValue(data, embeddedSize))
+                return false;
+            if (pathLength > data.size() || embeddedSize > data.size() - pathLength) return false;
+            binding.type = static_cast<aiTextureType>(type);
+            binding.path.resize(pathLength);
+            binding.embeddedData.resize(embeddedSize);
+            readBytes(data, binding.path.data(), pathLength);
+            readBytes(data, binding.embeddedData.data(), embeddedSize);
+        }
+    }
+    return data.empty();
+}
+
+std::vector<std::byte> IERenderable::writeMeshes() const {
+    std::vector<std::byte> data;
+    writeValue(data, MODEL_CACHE_MAGIC);
+    writeValue(data, static_cast<uint32_t>(meshes.size()));
+    for (const IEMesh &mesh : meshes) {
+        writeValue(data, static_cast<uint64_t>(mesh.vertices.size()));
+        writeValue(data, static_cast<uint64_t>(mesh.indices.size()));
+        writeValue(data, mesh.triangleCount);
+        writeValue(data, static_cast<uint32_t>(mesh.material->textureBindings.size()));
+        writeBytes(data, mesh.vertices.data(), mesh.vertices.size() * sizeof(IEVertex));
+        writeBytes(data, mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t));
+        for (const IEMaterial::TextureBinding &binding : mesh.material->textureBindings) {
+            writeValue(data, static_cast<uint32_t>(binding.type));
+            writeValue(data, static_cast<uint32_t>(binding.path.size()));
+            writeValue(data, static_cast<uint64_t>(binding.embeddedData.size()));
+            writeBytes(data, binding.path.data(), binding.path.size());
+            writeBytes(data, binding.embeddedData.data(), binding.embeddedData.size());
+        }
+    }
+    return data;
 }
 
 std::function<void(IERenderable &)> IERenderable::_loadFromRAMToVRAM{nullptr};
@@ -23,11 +23,15 @@ class IECamera;
 // External dependencies
 #include <assimp/BaseImporter.h>
 #include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
 #include <vulkan/vulkan.h>
 
 // System dependencies
+#include <cstddef>
 #include <functional>
+#include <span>
 #include <string>
+#include <vector>
 
 enum IERenderableStatus {
     IE_RENDERABLE_STATE_UNKNOWN  = 0x0,
@@ -38,6 +42,16 @@ enum IERenderableStatus {
 
 class IERenderable : public IEAspect {
 public:
+    /// The post-processing that models are imported with.
+    static constexpr uint32_t IMPORT_FLAGS{
+      aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_OptimizeMeshes | aiProcess_RemoveRedundantMaterials |
+      aiProcess_JoinIdenticalVertices | aiProcess_PreTransformVertices | aiProcess_SortByPType |
+      aiProcess_GenUVCoords | aiProcess_GenNormals | aiProcess_ValidateDataStructure |
+      aiProcess_ImproveCacheLocality | aiProcess_FixInfacingNormals | aiProcess_FindDegenerates |
+      aiProcess_FindInvalidData | aiProcess_FindInstances | aiProcess_Debone};
+    /// Changed whenever the format of cached models changes, so that old ones are ignored.
+    static constexpr uint32_t CACHE_VERSION{2};
+
     std::string           modelName{};
     std::vector<IEMesh>   meshes{};
     IEBuffer              modelBuffer{};
@@ -67,6 +81,27 @@ public:
     void _vulkanCreate(IERenderEngine *, const std::string &);
 
 
+    /**
+     * @brief Fill meshes with the vertices, indices and textures of the model.
+     * @details Imported models are kept in the file system's derived data, keyed by a hash of the model file,
+     * IMPORT_FLAGS and CACHE_VERSION. Later loads of an unchanged model read it back from there without Assimp.
+     * @return False if the model could not be imported.
+     */
+    bool loadMeshes();
+
+    /** Fill meshes from a model written by writeMeshes(). @return False if data is not a valid cached model. */
+    bool readMeshes(std::span<const std::byte> data);
+
+    /**
+     * Write meshes in the format read by readMeshes(). Texture paths must still be relative to the model, as they
+     * are before resolveTexturePaths(), so that moving the model and its textures does not invalidate the cache.
+     */
+    [[nodiscard]] std::vector<std::byte> writeMeshes() const;
+
+    /** Prefix the texture paths found in the model with the textures directory next to it, ready for loading. */
+    void resolveTexturePaths();
+
+
     static std::function<void(IERenderable &)> _loadFromDiskToRAM;
 
     void loadFromDiskToRAM();
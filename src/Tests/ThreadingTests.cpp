@@ -0,0 +1,95 @@
+#include "Core/ThreadingModule/TaskGraph.hpp"
+#include "Core/ThreadingModule/ThreadPool.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+/*
+ * Checks the thread pool's behavior with: IEThreadingTests
+ * Exits with a failure as soon as any check fails.
+ */
+
+namespace {
+// The same budget as IERenderEngine::MAIN_THREAD_BUDGET.
+constexpr std::chrono::microseconds MAIN_THREAD_BUDGET{2000};
+constexpr std::chrono::milliseconds UPLOAD_TIME{1};
+constexpr uint32_t                  UPLOAD_COUNT{100};
+// How long the frame's worker work takes. Long enough to run many uploads if the main thread ran them meanwhile.
+constexpr std::chrono::milliseconds RECORDING_TIME{20};
+
+void check(bool t_condition, const std::string &t_message) {
+    if (!t_condition) throw std::runtime_error(t_message);
+}
+
+/**
+ * @brief Render one frame the way IERenderEngine::update() does, then check how much of the uploads it ran.
+ * @details The frame runs a budget of main thread work, followed by a frame graph with a main thread node that
+ * waits for worker work, which must not be used to run the uploads that the budget left waiting. Once the budget
+ * is spent, waiting for a task that needs the main thread must still run the uploads queued ahead of it.
+ */
+IE::Core::Threading::Task<void>
+renderFrame(IE::Core::Threading::ThreadPool &t_threadPool, std::exception_ptr &t_failure) {
+    std::atomic<uint32_t> uploads{0};
+    try {
+        auto upload = [&uploads] {
+            std::this_thread::sleep_for(UPLOAD_TIME);
+            ++uploads;
+        };
+        for (uint32_t i{0}; i < UPLOAD_COUNT; ++i)
+            t_threadPool.submit(IE::Core::Threading::IE_THREAD_TYPE_MAIN_THREAD, upload);
+        IE::Core::Threading::TaskGraph frameGraph{&t_threadPool};
+        auto acquire = frameGraph.addNode("Acquire", [] {}, IE::Core::Threading::IE_THREAD_TYPE_MAIN_THREAD);
+        auto record = frameGraph.addNode(
+          "Record",
+          [&t_threadPool] {
+              auto work      = [] { std::this_thread::sleep_for(RECORDING_TIME); };
+              auto recording = t_threadPool.submit(IE::Core::Threading::IE_THREAD_TYPE_WORKER_THREAD, work);
+              IE::Core::Threading::Worker::waitForTask(&t_threadPool, *recording);
+          },
+          IE::Core::Threading::IE_THREAD_TYPE_MAIN_THREAD
+        );
+        frameGraph.addDependency(record, acquire);
+
+        t_threadPool.pumpMainThread(MAIN_THREAD_BUDGET);
+        frameGraph.runAndWait();
+        // The budget fits about two uploads, but the first one always runs, and the clock is coarse.
+        uint32_t ran = uploads.load();
+        check(ran >= 1 && ran <= 4, "A frame ran " + std::to_string(ran) + " uploads, beyond its budget");
+        check(
+          t_threadPool.getStatistics().mainQueueDepth == UPLOAD_COUNT - ran,
+          "The uploads left over by a frame are no longer waiting"
+        );
+
+        auto last = t_threadPool.submit(IE::Core::Threading::IE_THREAD_TYPE_MAIN_THREAD, upload);
+        IE::Core::Threading::Worker::waitForTask(&t_threadPool, *last);
+        check(uploads.load() == UPLOAD_COUNT + 1, "Waiting past the budget skipped main thread work");
+    } catch (...) {
+        t_failure = std::current_exception();
+    }
+    t_threadPool.shutdown();
+    co_return;
+}
+}  // namespace
+
+int main() {
+    std::exception_ptr failure;
+    {
+        IE::Core::Threading::ThreadPool threadPool{2};
+        threadPool.submit(IE::Core::Threading::IE_THREAD_TYPE_MAIN_THREAD, renderFrame(threadPool, failure));
+        threadPool.startMainThreadLoop();
+    }
+    try {
+        if (failure) std::rethrow_exception(failure);
+    } catch (const std::exception &exception) {
+        std::cerr << exception.what() << "\n";
+        return 1;
+    }
+    std::cout << "All thread pool checks passed.\n";
+    return 0;
+}
@@ -0,0 +1,313 @@
+#include "Core/FileSystemModule/FileSystem.hpp"
+#include "Core/ThreadingModule/Queue.hpp"
+#include "Core/ThreadingModule/ThreadPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Measures the engine's threading primitives and file system, with: IEBenchmark [tree directory]
+ * The file system is measured against a tree of TREE_FILE_COUNT files in the given directory, which is generated
+ * on the first run and reused after that. Every measurement of it reads the tree through the same page cache.
+ */
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr uint64_t    QUEUE_OPERATIONS_PER_THREAD{1'000'000};
+constexpr uint64_t    TINY_TASK_COUNT{1'000'000};
+constexpr uint32_t    WAKEUP_COUNT{1000};
+constexpr std::size_t VERTEX_COUNT{10'000'000};
+constexpr uint32_t    TREE_DIRECTORY_COUNT{100};
+constexpr uint32_t    TREE_FILE_COUNT{100'000};
+constexpr uint32_t    FIRST_FRAME_FILE_COUNT{1000};
+
+std::atomic<uint64_t> allocationCount{0};
+
+double millisecondsSince(Clock::time_point t_start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t_start).count();
+}
+
+/** The thread counts to measure with: powers of two up to the number of hardware threads, and that number. */
+std::vector<uint32_t> threadCounts() {
+    uint32_t              hardwareThreads = std::max(std::thread::hardware_concurrency(), 1U);
+    std::vector<uint32_t> counts;
+    for (uint32_t count = 1; count < hardwareThreads; count *= 2) counts.push_back(count);
+    counts.push_back(hardwareThreads);
+    return counts;
+}
+
+/**
+ * @brief Block until t_task has finished, without running any of the pool's tasks on this thread.
+ * @details This thread is not one of the pool's threads, so helping out like Worker::waitForTask() does would have
+ * every measurement run with one thread more than the pool has workers.
+ */
+void waitWithoutHelping(const IE::Core::Threading::BaseTask &t_task) {
+    t_task.m_finished.wait(false, std::memory_order_acquire);
+}
+
+IE::Core::Threading::Task<void> increment(std::atomic<uint64_t> *t_counter) {
+    t_counter->fetch_add(1, std::memory_order_relaxed);
+    co_return;
+}
+
+IE::Core::Threading::Task<void> recordStart(std::atomic<Clock::rep> *t_start) {
+    t_start->store(Clock::now().time_since_epoch().count(), std::memory_order_release);
+    co_return;
+}
+
+/** Threads that each push and pop QUEUE_OPERATIONS_PER_THREAD elements on one queue at the same time. */
+void benchmarkQueueContention() {
+    std::cout << "Queue contention\n";
+    for (uint32_t threadCount : threadCounts()) {
+        IE::Core::Threading::Queue<uint64_t> queue;
+        std::vector<std::thread>             threads;
+        Clock::time_point                    start = Clock::now();
+        for (uint32_t i = 0; i < threadCount; ++i) {
+            threads.emplace_back([&queue] {
+                uint64_t value;
+                for (uint64_t operation = 0; operation < QUEUE_OPERATIONS_PER_THREAD; ++operation) {
+                    queue.push(operation);
+                    while (!queue.pop(value)) std::this_thread::yield();
+                }
+            });
+        }
+        for (std::thread &thread : threads) thread.join();
+        double seconds = millisecondsSince(start) / 1000;
+        std::cout << "  " << threadCount << " threads: "
+                  << static_cast<uint64_t>(threadCount * QUEUE_OPERATIONS_PER_THREAD / seconds)
+                  << " push and pop pairs per second\n";
+    }
+}
+
+/** TINY_TASK_COUNT tasks that do nearly nothing, submitted to the pool from outside of it. */
+void benchmarkTaskThroughput(IE::Core::Threading::ThreadPool &t_threadPool) {
+    std::cout << "Tiny tasks\n";
+    for (uint32_t workerCount : threadCounts()) {
+        t_threadPool.setWorkerCount(workerCount);
+        std::atomic<uint64_t>                                         counter{0};
+        std::vector<std::shared_ptr<IE::Core::Threading::Task<void>>> tasks;
+        tasks.reserve(TINY_TASK_COUNT);
+        uint64_t          allocations = allocationCount.load();
+        Clock::time_point start       = Clock::now();
+        for (uint64_t i = 0; i < TINY_TASK_COUNT; ++i) {
+            tasks.push_back(
+              t_threadPool.submit(IE::Core::Threading::IE_THREAD_TYPE_WORKER_THREAD, increment(&counter))
+            );
+        }
+        for (const std::shared_ptr<IE::Core::Threading::Task<void>> &task : tasks) waitWithoutHelping(*task);
+        double seconds = millisecondsSince(start) / 1000;
+        allocations    = allocationCount.load() - allocations;
+        std::cout << "  " << workerCount << " workers: " << static_cast<uint64_t>(TINY_TASK_COUNT / seconds)
+                  << " tasks per second, " << static_cast<double>(allocations) / TINY_TASK_COUNT
+                  << " heap allocations per task\n";
+    }
+    t_threadPool.setWorkerCount();
+}
+
+/**
+ * @brief How long an idle worker takes to start a task, and how much CPU time idle workers use.
+ * @details Each task is submitted after the workers have had time to go to sleep, so every one of them measures
+ * a full wakeup.
+ */
+void benchmarkWakeups(IE::Core::Threading::ThreadPool &t_threadPool) {
+    std::cout << "Wakeups\n";
+    std::vector<double> latencies;
+    for (uint32_t i = 0; i < WAKEUP_COUNT; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        std::atomic<Clock::rep> taskStart{0};
+        Clock::time_point       submitted = Clock::now();
+        auto                    task =
+          t_threadPool.submit(IE::Core::Threading::IE_THREAD_TYPE_WORKER_THREAD, recordStart(&taskStart));
+        waitWithoutHelping(*task);
+        Clock::time_point started{Clock::duration(taskStart.load())};
+        latencies.push_back(std::chrono::duration<double, std::micro>(started - submitted).count());
+    }
+    std::sort(latencies.begin(), latencies.end());
+    std::cout << "  Wake to run: " << latencies[latencies.size() / 2] << " us median, "
+              << latencies[latencies.size() * 99 / 100] << " us 99th percentile\n";
+
+    // std::clock() counts the CPU time of every thread in the process, which is only the idle workers here.
+    std::clock_t      cpuStart = std::clock();
+    Clock::time_point start    = Clock::now();
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    double cpuMilliseconds = 1000.0 * static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+    std::cout << "  Idle: " << cpuMilliseconds << " ms of CPU time in " << millisecondsSince(start)
+              << " ms with " << t_threadPool.getWorkerCount() << " workers\n";
+}
+
+/** Convert, sum and sort a synthetic mesh of VERTEX_COUNT vertices serially and with the parallel algorithms. */
+void benchmarkParallelAlgorithms(IE::Core::Threading::ThreadPool &t_threadPool) {
+    std::cout << "Parallel algorithms on " << VERTEX_COUNT << " vertices with " << t_threadPool.getWorkerCount()
+              << " workers\n";
+    std::vector<float>   positions(VERTEX_COUNT * 3);
+    std::vector<float>   converted(VERTEX_COUNT * 3);
+    std::vector<int32_t> keys(VERTEX_COUNT);
+    std::mt19937         random{0};
+    for (float &position : positions) position = static_cast<float>(random() % 1000);
+    for (int32_t &key : keys) key = static_cast<int32_t>(random());
+    auto convert = [&](std::size_t t_vertex) {
+        converted[3 * t_vertex]     = positions[3 * t_vertex] * 2.0F;
+        converted[3 * t_vertex + 1] = positions[3 * t_vertex + 1] + 1.0F;
+        converted[3 * t_vertex + 2] = -positions[3 * t_vertex + 2];
+    };
+    auto height = [&](std::size_t t_vertex) { return static_cast<double>(positions[3 * t_vertex + 1]); };
+    auto add    = [](double t_left, double t_right) { return t_left + t_right; };
+
+    Clock::time_point start = Clock::now();
+    for (std::size_t vertex = 0; vertex < VERTEX_COUNT; ++vertex) convert(vertex);
+    double serialFor = millisecondsSince(start);
+    start            = Clock::now();
+    auto parallelFor = t_threadPool.parallelFor(0, VERTEX_COUNT, 0, convert);
+    waitWithoutHelping(*parallelFor);
+    std::cout << "  For: " << serialFor << " ms serial, " << millisecondsSince(start) << " ms parallel\n";
+
+    start      = Clock::now();
+    double sum = 0;
+    for (std::size_t vertex = 0; vertex < VERTEX_COUNT; ++vertex) sum = add(sum, height(vertex));
+    double serialReduce = millisecondsSince(start);
+    start               = Clock::now();
+    auto parallelReduce =
+      t_threadPool.parallelReduce(std::size_t{0}, VERTEX_COUNT, std::size_t{0}, 0.0, height, add);
+    waitWithoutHelping(*parallelReduce);
+    std::cout << "  Reduce: " << serialReduce << " ms serial, " << millisecondsSince(start) << " ms parallel"
+              << (parallelReduce->value() == sum ? "\n" : ", with a different sum\n");
+
+    std::vector<int32_t> serialKeys = keys;
+    start                           = Clock::now();
+    std::sort(serialKeys.begin(), serialKeys.end());
+    double serialSort = millisecondsSince(start);
+    start             = Clock::now();
+    auto parallelSort = t_threadPool.parallelSort(keys.begin(), keys.end());
+    waitWithoutHelping(*parallelSort);
+    std::cout << "  Sort: " << serialSort << " ms serial, " << millisecondsSince(start) << " ms parallel"
+              << (keys == serialKeys ? "\n" : ", with a different order\n");
+}
+
+/** Fill t_directory with TREE_FILE_COUNT small files spread over TREE_DIRECTORY_COUNT directories. */
+void generateTree(const std::filesystem::path &t_directory) {
+    for (uint32_t i = 0; i < TREE_FILE_COUNT; ++i) {
+        std::filesystem::path directory = t_directory / ("directory" + std::to_string(i % TREE_DIRECTORY_COUNT));
+        if (i < TREE_DIRECTORY_COUNT) std::filesystem::create_directories(directory);
+        std::ofstream{directory / ("file" + std::to_string(i))} << "Contents of file " << i << '\n';
+    }
+}
+
+/** The i-th of the FIRST_FRAME_FILE_COUNT files that the first frame loads, spread over the whole tree. */
+std::filesystem::path firstFrameFile(uint32_t t_index) {
+    uint32_t file = t_index * (TREE_FILE_COUNT / FIRST_FRAME_FILE_COUNT);
+    return "directory" + std::to_string(file % TREE_DIRECTORY_COUNT) + "/file" + std::to_string(file);
+}
+
+/**
+ * @brief The time to look up and hash the first frame's files after indexing the whole tree up front.
+ * @details This is what setBaseDirectory() did before it indexed lazily: walk every directory below the base
+ * directory and open every file in it to find its size, before a single file could be used.
+ */
+double timeToFirstFrameEagerly(const std::filesystem::path &t_directory) {
+    Clock::time_point                               start = Clock::now();
+    std::unordered_map<std::string, IE::Core::File> files;
+    for (const auto &entry : std::filesystem::recursive_directory_iterator{t_directory})
+        if (!entry.is_directory()) files.emplace(entry.path().string(), IE::Core::File{entry.path()});
+    for (uint32_t i = 0; i < FIRST_FRAME_FILE_COUNT; ++i) {
+        std::filesystem::path path = t_directory / firstFrameFile(i);
+        auto                  file = files.find(path.string());
+        // Hash the contents like getContentHash() does, for which 0 also means that there is no such file.
+        IE::Core::FileMapping      mapping = file != files.end() ? file->second.map() : IE::Core::FileMapping{};
+        std::span<const std::byte> bytes   = mapping.bytes();
+        if (bytes.empty() || IE::Core::FileSystem::hashContents(bytes) == 0)
+            throw std::runtime_error("missing file in benchmark tree: " + path.string());
+    }
+    return millisecondsSince(start);
+}
+
+/** The time from creating a FileSystem to having looked up and hashed the first frame's files. */
+double timeToFirstFrame(const std::filesystem::path &t_directory) {
+    Clock::time_point    start = Clock::now();
+    IE::Core::FileSystem fileSystem;
+    fileSystem.setBaseDirectory(t_directory);
+    for (uint32_t i = 0; i < FIRST_FRAME_FILE_COUNT; ++i) {
+        std::filesystem::path path = firstFrameFile(i);
+        if (fileSystem.getFile(path) == nullptr || fileSystem.getContentHash(path) == 0)
+            throw std::runtime_error("missing file in benchmark tree: " + path.string());
+    }
+    double milliseconds = millisecondsSince(start);
+    // Saving the index happens on shutdown, so is not part of the time to the first frame.
+    fileSystem.saveIndex();
+    return milliseconds;
+}
+
+void benchmarkFileSystem(const std::filesystem::path &t_directory) {
+    std::cout << "File system on a tree of " << TREE_FILE_COUNT << " files in " << t_directory.string() << "\n";
+    if (!std::filesystem::exists(t_directory / "directory0")) {
+        Clock::time_point start = Clock::now();
+        generateTree(t_directory);
+        std::cout << "  Generated the tree in " << millisecondsSince(start) << " ms\n";
+    }
+    std::filesystem::remove(t_directory / IE::Core::FileSystem::INDEX_CACHE_PATH);
+    double eager = timeToFirstFrameEagerly(t_directory);
+    double cold  = timeToFirstFrame(t_directory);
+    double warm  = timeToFirstFrame(t_directory);
+    std::cout << "  Time to first frame with " << FIRST_FRAME_FILE_COUNT << " files: " << eager
+              << " ms indexing the whole tree, " << cold << " ms without an index, " << warm
+              << " ms with the saved index\n";
+}
+}  // namespace
+
+// Count every allocation, so that the benchmarks can report how many they make.
+void *operator new(std::size_t t_size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void *pointer = std::malloc(t_size != 0 ? t_size : 1)) return pointer;
+    throw std::bad_alloc{};
+}
+
+void operator delete(void *t_pointer) noexcept {
+    std::free(t_pointer);
+}
+
+void operator delete(void *t_pointer, std::size_t) noexcept {
+    std::free(t_pointer);
+}
+
+int main(int argc, char **argv) {
+    if (argc > 2) {
+        std::cerr << "Usage: " << argv[0] << " [tree directory]\n";
+        return 1;
+    }
+    try {
+        benchmarkQueueContention();
+        {
+            IE::Core::Threading::ThreadPool threadPool;
+            benchmarkTaskThroughput(threadPool);
+            benchmarkWakeups(threadPool);
+            benchmarkParallelAlgorithms(threadPool);
+            threadPool.shutdown();
+        }
+        benchmarkFileSystem(
+          argc == 2 ? std::filesystem::path(argv[1]) :
+                      std::filesystem::temp_directory_path() / "IEBenchmarkTree"
+        );
+    } catch (const std::exception &exception) {
+        std::cerr << exception.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,19 @@
+#include "Core/FileSystemModule/Pack.hpp"
+
+#include <exception>
+#include <iostream>
+
+int main(int argc, char **argv) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <directory> <pack>\n";
+        return 1;
+    }
+    try {
+        uint64_t fileCount = IE::Core::Pack::build(argv[1], argv[2]);
+        std::cout << "Packed " << fileCount << " files into " << argv[2] << "\n";
+    } catch (const std::exception &exception) {
+        std::cerr << exception.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
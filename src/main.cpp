@@ -88,6 +88,8 @@ IE::Core::Threading::Task<void> illuminationEngine() {
 
 int main(int argc, char **argv) {
     if (argc >= 1) IE::Core::Core::getInst(std::filesystem::path(argv[0]).parent_path().string());
+    // Give up worker threads while the engine is idle, and take them back when there is work again.
+    IE::Core::Core::getThreadPool()->setAdaptiveWorkerCount(1);
 
     auto main = IE::Core::Core::getThreadPool()->submit(
       IE::Core::Threading::IE_THREAD_TYPE_MAIN_THREAD,